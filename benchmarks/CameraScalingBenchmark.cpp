@@ -0,0 +1,58 @@
+// Draws full views of sprites at several console sizes, once on the calling
+// thread and once in row bands on the thread pool, and prints the time per
+// frame of each. The smallest size where the bands win is the value to pass
+// to SetParallelRenderCells on this machine.
+#include "Silver.hpp"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <thread>
+
+static const int frames = 50;
+
+// Every frame is redrawn in full, so the diff against the last one saves nothing
+static double MillisecondsPerFrame(Camera &camera) {
+  camera.RenderFrame();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) {
+    camera.InvalidateFrame();
+    camera.RenderFrame();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main() {
+  const int sizes[][2] = {{80, 25}, {120, 40}, {200, 60}, {300, 100}, {400, 150}};
+
+  std::printf("%u hardware threads, %u pool workers, %d frames\n",
+              std::thread::hardware_concurrency(), GetThreadPool().GetThreadCount(), frames);
+  if (std::thread::hardware_concurrency() <= 1) {
+    std::printf("One hardware thread: views are never banded, both columns are serial\n");
+  }
+  std::printf("%9s %8s %10s %10s %7s\n", "size", "cells", "serial ms", "banded ms", "ratio");
+
+  for (const auto &size : sizes) {
+    int width = size[0], height = size[1];
+    auto surface = std::make_shared<HeadlessSurface>(width, height);
+    Actor cameraActor;
+    Camera *camera = cameraActor.AddComponent<Camera>();
+    camera->SetSurface(surface);
+
+    // A 3x2 sprite every 4 columns and 3 rows covers half the view
+    Actor tile("tile", "<red>#@#</red>\n<blue>@#@</blue>");
+    for (int y = -height / 2; y < height / 2; y += 3) {
+      for (int x = -width / 2; x < width / 2; x += 4) tile.PlaceObjectAt(Vector3(x, y, 0));
+    }
+
+    SetParallelRenderCells(INT_MAX);
+    double serial = MillisecondsPerFrame(*camera);
+    SetParallelRenderCells(0);
+    double banded = MillisecondsPerFrame(*camera);
+
+    std::printf("%4dx%-4d %8d %10.3f %10.3f %7.2f\n", width, height, width * height, serial, banded,
+                serial / banded);
+    Workspace.clear();
+  }
+  return 0;
+}
@@ -0,0 +1,38 @@
+// Counts the console size queries of a typical frame: PollEvents, a camera
+// frame, three Gotoxy calls and GetConsoleCenter. The frames go to the real
+// console backend for its size but their bytes are dropped, so the count is
+// all that is printed.
+#include "Silver.hpp"
+#include <cstdio>
+
+static const int frames = 100;
+
+class QuietConsole : public ConsoleSurface {
+public:
+  int Write(const std::string &) override { return 1; }
+  void Clear() override {}
+};
+
+int main() {
+  auto console = std::make_shared<QuietConsole>();
+  SetTerminalSurface(console);
+
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->topText = "HP 10";
+  Actor player("player", "@");
+  player.PlaceObjectAt(Vector3(0, 0, 0));
+
+  size_t before = console->GetSizeQueries();
+  for (int i = 0; i < frames; i++) {
+    PollEvents();
+    camera->RenderFrame();
+    for (int line = 0; line < 3; line++) Gotoxy(0, line);
+    GetConsoleCenter();
+  }
+  size_t queries = console->GetSizeQueries() - before;
+
+  std::printf("%d frames, %zu console size queries, %.2f per frame\n", frames, queries,
+              static_cast<double>(queries) / frames);
+  return 0;
+}
@@ -0,0 +1,93 @@
+// Looks components up on 10k actors with six components each, through the
+// slot table behind Actor::GetComponent and through the linear
+// dynamic_pointer_cast scan it replaced, and prints the time per lookup.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+static const int actorCount = 10000;
+static const int rounds = 100;
+
+// Game components, added after the engine ones
+struct Health : Component {
+  std::shared_ptr<Component> Clone() const override { return std::make_shared<Health>(*this); }
+  void Update(float) override {}
+  int points = 10;
+};
+struct Velocity : Component {
+  std::shared_ptr<Component> Clone() const override { return std::make_shared<Velocity>(*this); }
+  void Update(float) override {}
+  Vector3 value;
+};
+struct Inventory : Component {
+  std::shared_ptr<Component> Clone() const override { return std::make_shared<Inventory>(*this); }
+  void Update(float) override {}
+};
+
+using ComponentList = std::vector<std::shared_ptr<Component>>;
+
+// GetComponent before the slot table
+template <typename T> static T *ScanComponents(const ComponentList &components) {
+  for (const auto &component : components) {
+    if (auto castedComponent = std::dynamic_pointer_cast<T>(component)) return castedComponent.get();
+  }
+  return nullptr;
+}
+
+template <typename F> static double NanosecondsPerLookup(F lookup) {
+  size_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) found += lookup();
+  auto end = std::chrono::steady_clock::now();
+  if (found == 12345) std::printf(" "); // Keeps the lookups from being dropped
+  return std::chrono::duration<double, std::nano>(end - start).count() / (double(rounds) * actorCount);
+}
+
+template <typename T>
+static void Compare(const char *name, const std::vector<std::unique_ptr<Actor>> &actors,
+                    const std::vector<ComponentList> &lists) {
+  double slots = NanosecondsPerLookup([&] {
+    size_t found = 0;
+    for (const auto &actor : actors) found += actor->GetComponent<T>() != nullptr;
+    return found;
+  });
+  double scan = NanosecondsPerLookup([&] {
+    size_t found = 0;
+    for (const ComponentList &list : lists) found += ScanComponents<T>(list) != nullptr;
+    return found;
+  });
+  std::printf("%-16s %8.2f %8.2f %7.1fx\n", name, slots, scan, scan / slots);
+}
+
+int main() {
+  std::vector<std::unique_ptr<Actor>> actors;
+  std::vector<ComponentList> lists; // The same components, in the order they were added
+  for (int i = 0; i < actorCount; i++) {
+    auto actor = std::make_unique<Actor>("unit", "u");
+    ComponentList list;
+    // Not owned by the list, the actor keeps them alive
+    list.emplace_back(std::shared_ptr<Component>(), actor->GetComponent<Transform>());
+    list.emplace_back(std::shared_ptr<Component>(), actor->GetComponent<SpriteRenderer>());
+    auto health = std::make_shared<Health>();
+    auto velocity = std::make_shared<Velocity>();
+    auto inventory = std::make_shared<Inventory>();
+    auto ui = std::make_shared<UI>();
+    actor->AddComponent(health);
+    actor->AddComponent(velocity);
+    actor->AddComponent(inventory);
+    actor->AddComponent(ui);
+    list.insert(list.end(), {health, velocity, inventory, ui});
+    actors.push_back(std::move(actor));
+    lists.push_back(std::move(list));
+  }
+
+  std::printf("%d actors, 6 components each, ns per lookup\n", actorCount);
+  std::printf("%-16s %8s %8s %8s\n", "component", "slots", "scan", "speedup");
+  Compare<Transform>("Transform (1st)", actors, lists);
+  Compare<Velocity>("Velocity (4th)", actors, lists);
+  Compare<UI>("UI (6th)", actors, lists);
+  Compare<Camera>("Camera (absent)", actors, lists);
+  return 0;
+}
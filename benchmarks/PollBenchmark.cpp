@@ -0,0 +1,96 @@
+// Times PollEvents, which keeps key state in bitsets and queues transitions
+// in a ring, against the per-key loop it replaced, which updated three bool
+// arrays with one GetAsyncKeyState call per key. Both read the same stub
+// keyboard, so the numbers are the engine's own cost per poll; the 256
+// GetAsyncKeyState calls a Windows poll makes are the same for both and are
+// not included.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+
+static const int polls = 200000;
+
+// What the stub keyboard reports, and how often it was asked
+static bool heldKeys[256];
+static long keyStateCalls = 0;
+
+static short StubAsyncKeyState(int key) {
+  keyStateCalls++;
+  return heldKeys[key] ? static_cast<short>(0x8000) : 0;
+}
+
+// LiveInputSource::Read on Windows, over the stub
+class StubKeyboardSource : public InputSource {
+public:
+  void Read(InputFrame &frame) override {
+    frame.keys = KeySet();
+    for (int i = 0; i < 256; i++) {
+      if (StubAsyncKeyState(i) & 0x8000) frame.keys.Set(i, true);
+    }
+  }
+  bool ProvidesCursor() const override { return true; } // Leaves the virtual mouse out
+};
+
+// PollEvents before the bitsets, over the stub
+static bool oldKeyStates[256], oldKeyDownStates[256], oldKeyUpStates[256];
+
+static void PollEventsPerKey() {
+  for (int i = 0; i < 256; i++) {
+    bool currentState = (StubAsyncKeyState(i) & 0x8000) != 0;
+    oldKeyDownStates[i] = currentState && !oldKeyStates[i];
+    oldKeyUpStates[i] = !currentState && oldKeyStates[i];
+    oldKeyStates[i] = currentState;
+  }
+
+  int cursorX = cursorPositionX, cursorY = cursorPositionY;
+  bool publishHeld = InputEvents.HasSubscribers(InputEventType::KeyHeld);
+  for (int i = 0; i < 256; i++) {
+    if (oldKeyDownStates[i]) InputEvents.Publish({InputEventType::KeyDown, i, cursorX, cursorY});
+    if (oldKeyUpStates[i]) InputEvents.Publish({InputEventType::KeyUp, i, cursorX, cursorY});
+    if (publishHeld && oldKeyStates[i]) InputEvents.Publish({InputEventType::KeyHeld, i, cursorX, cursorY});
+  }
+  InputEvents.Publish({InputEventType::Frame, -1, cursorX, cursorY});
+}
+
+// setKeys(poll) picks the held keys before each poll
+template <typename Poll, typename SetKeys> static double NanosecondsPerPoll(Poll poll, SetKeys setKeys) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < polls; i++) {
+    setKeys(i);
+    poll();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / polls;
+}
+
+template <typename SetKeys> static void Compare(const char *name, SetKeys setKeys) {
+  double perKey = NanosecondsPerPoll(PollEventsPerKey, setKeys);
+  double bitsets = NanosecondsPerPoll(PollEvents, setKeys);
+  std::printf("%-22s %9.1f %9.1f %7.2fx\n", name, perKey, bitsets, perKey / bitsets);
+}
+
+int main() {
+  // No console size queries, so only input is timed
+  SetTerminalSurface(std::make_shared<HeadlessSurface>(80, 25));
+  SetInputSource(std::make_shared<StubKeyboardSource>());
+  PollEvents();
+
+  std::printf("%d polls, ns per poll\n", polls);
+  std::printf("%-22s %9s %9s %8s\n", "keys", "per-key", "bitsets", "speedup");
+  Compare("none held", [](int) {});
+  Compare("3 held", [](int poll) {
+    if (poll == 0) heldKeys['W'] = heldKeys[KEY_UP] = heldKeys[KEY_SPACE] = true;
+  });
+  Compare("3 toggled every poll", [](int poll) {
+    heldKeys['W'] = heldKeys[KEY_UP] = heldKeys[KEY_SPACE] = poll % 2 == 0;
+  });
+
+  // Held keys also publish a KeyHeld event each poll
+  InputEvents.Subscribe(InputEventType::KeyHeld, -1, [](const InputEvent &) {});
+  Compare("3 held, KeyHeld on", [](int poll) {
+    if (poll == 0) heldKeys['W'] = heldKeys[KEY_UP] = heldKeys[KEY_SPACE] = true;
+  });
+
+  std::printf("stub key reads per poll: %ld\n", keyStateCalls / (8L * polls));
+  return 0;
+}
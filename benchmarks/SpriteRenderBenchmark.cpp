@@ -0,0 +1,66 @@
+// Renders 1,000 sprites in an 80x25 view and prints the time per frame when
+// nothing moves and when every sprite moves each frame. Output goes to a
+// surface that only counts bytes, so the console's own speed is left out.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static const int spriteCount = 1000;
+static const int frames = 200;
+
+class CountingSurface : public TerminalSurface {
+public:
+  Vector2 GetSize() override { return Vector2(80, 25); }
+  int Write(const std::string &bytes) override {
+    written += bytes.size();
+    return 1;
+  }
+  void Clear() override {}
+
+  size_t written = 0;
+};
+
+template <typename F> static double MillisecondsPerFrame(F frame) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) frame(i);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main() {
+  auto surface = std::make_shared<CountingSurface>();
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(surface);
+
+  // Four shapes, some styled, scattered over the view
+  const char *shapes[] = {"<red>ab</red>c\nxyz", "###\n# #\n###", "<blue>o</blue>", "abcd\nefgh"};
+  std::srand(7);
+  for (int i = 0; i < spriteCount; i++) {
+    Actor sprite("sprite", shapes[i % 4]);
+    sprite.PlaceObjectAt(Vector3(std::rand() % 80 - 40, std::rand() % 24 - 12, std::rand() % 5));
+  }
+  std::vector<Transform *> transforms;
+  for (auto &entry : Workspace) {
+    if (Transform *transform = entry.second->GetComponent<Transform>()) transforms.push_back(transform);
+  }
+
+  camera->RenderFrame();
+  surface->written = 0;
+  double still = MillisecondsPerFrame([&](int) { camera->RenderFrame(); });
+  size_t stillBytes = surface->written / frames;
+
+  surface->written = 0;
+  double moving = MillisecondsPerFrame([&](int frame) {
+    Vector3 step(frame % 2 ? 1 : -1, 0, 0);
+    for (Transform *transform : transforms) transform->Translate(step);
+    camera->RenderFrame();
+  });
+  size_t movingBytes = surface->written / frames;
+
+  std::printf("%d sprites, 80x25 view, %d frames\n", spriteCount, frames);
+  std::printf("still   %8.3f ms/frame %8zu bytes/frame\n", still, stillBytes);
+  std::printf("moving  %8.3f ms/frame %8zu bytes/frame\n", moving, movingBytes);
+  return 0;
+}
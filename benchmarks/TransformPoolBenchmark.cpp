@@ -0,0 +1,45 @@
+// Moves 100k placed actors once per frame, through the TransformPool batch
+// updates and through per-actor Transform::Translate, and prints the time
+// each takes per frame.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+
+static const int actorCount = 100000;
+static const int frames = 100;
+
+template <typename F> static double MillisecondsPerFrame(F frame) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) frame();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main() {
+  auto tile = std::make_shared<Actor>("tile", "#");
+  tile->SetTag("enemy");
+  tile->GetComponent<Transform>()->SetDense(true);
+  for (int i = 0; i < actorCount; i++) tile->PlaceObjectAt(Vector3(i % 400, i / 400, 0));
+
+  TransformPool &pool = GetTransformPool();
+  std::vector<Transform *> transforms;
+  for (auto &entry : Workspace) {
+    Transform *transform = entry.second->GetComponent<Transform>();
+    if (!transform || !transform->IsDense()) continue;
+    pool.SetVelocity(transform->GetHandle(), Vector3(1, 0.5, 0));
+    transforms.push_back(transform);
+  }
+  int enemy = InternTag("enemy");
+
+  double advance = MillisecondsPerFrame([&] { pool.AdvanceVelocities(0.016); });
+  double tagged = MillisecondsPerFrame([&] { pool.TranslateTagged(enemy, Vector3(1, 0, 0)); });
+  double perActor = MillisecondsPerFrame([&] {
+    for (Transform *transform : transforms) transform->Translate(Vector3(1, 0, 0));
+  });
+
+  std::printf("%zu rows, %d frames\n", pool.Size(), frames);
+  std::printf("AdvanceVelocities   %8.3f ms/frame\n", advance);
+  std::printf("TranslateTagged     %8.3f ms/frame\n", tagged);
+  std::printf("Transform::Translate %7.3f ms/frame\n", perActor);
+  return 0;
+}
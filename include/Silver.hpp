@@ -3,10 +3,23 @@
 
 // Project-specific headers
 #include "SilverColor.hpp"
+#include "SilverEvents.hpp"
+#include "SilverFrameBuffer.hpp"
+#include "SilverInput.hpp"
 #include "SilverKeyboard.hpp"
 #include "SilverMusic.hpp"
+#include "SilverPool.hpp"
+#include "SilverScheduler.hpp"
+#include "SilverScript.hpp"
+#include "SilverSnapshot.hpp"
+#include "SilverSpatial.hpp"
+#include "SilverTags.hpp"
+#include "SilverTerminal.hpp"
+#include "SilverThreadPool.hpp"
 #include "SilverThreading.hpp"
 #include "SilverTimer.hpp"
+#include "SilverTimerWheel.hpp"
+#include "SilverTransformPool.hpp"
 #include "SilverVMouse.hpp"
 #include "smath.hpp"
 
@@ -20,12 +33,14 @@
 #include <locale>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <set>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <type_traits>
+#include <typeindex>
 #include <unordered_map>
 
 #define SPActor std::shared_ptr<Actor>
@@ -48,10 +63,11 @@ extern std::map<std::string, Actor> Prefabs; // A collection to store pre-made o
 extern World Workspace;
 
 extern bool debugMode;
+extern std::atomic<unsigned> consoleClearCount; // Bumped by Clear()
 
 class Component {
 protected:
-  Actor* parent; // Keeping it lowercase as intended
+  Actor* parent = nullptr; // Keeping it lowercase as intended
 
 public:
   explicit Component(Actor* parent)
@@ -63,43 +79,145 @@ public:
 
   virtual void Update(float deltaTime) = 0; // Pure virtual function
 
+  // Return true when Update only touches this component and its own actor.
+  // The Scheduler then runs components of this type on several threads.
+  virtual bool IsIndependent() const { return false; }
+
   Actor* GetParent() const { return parent; } // Safe accessor
   void UnsafeSetParent(Actor* target) {
     parent = target;
   }
 };
 
+// Small dense IDs for component types, handed out on first use. Actors keep
+// their components in a slot table indexed by these IDs.
+size_t ComponentTypeID(const std::type_index &type);
+
+template <typename T> size_t ComponentTypeID() {
+  static const size_t id = ComponentTypeID(std::type_index(typeid(T)));
+  return id;
+}
+
 class Transform : public Component {
 public:
     Transform() = default;
     explicit Transform(Actor* parent) : Component(parent) {}
 
-    Transform(const Transform& other) = default;
-    Transform& operator=(const Transform& other) = default;
+    Transform(const Transform& other); // A copy of a dense transform is dense too
+    Transform& operator=(const Transform& other);
+    ~Transform();
 
     std::shared_ptr<Component> Clone() const override {
-        return std::make_shared<Transform>(*this);
+        return std::allocate_shared<Transform>(PoolAllocator<Transform>(), *this);
     }
 
+    // A dense transform lives in its TransformPool row, the rest in the
+    // fields below. The setters also keep the spatial index in sync.
+    Vector3 GetPosition() const {
+        return handle.IsValid() ? GetTransformPool().GetPosition(handle) : position;
+    }
+    double GetRotation() const {
+        return handle.IsValid() ? GetTransformPool().GetRotation(handle) : rotation;
+    }
+    Vector3 GetScale() const {
+        return handle.IsValid() ? GetTransformPool().GetScale(handle) : scale;
+    }
+    void SetPosition(Vector3 value);
+    void SetRotation(double value);
+    void SetScale(Vector3 value);
     void Translate(Vector3 offset);
+    void MarkMoved();
     void Update(float deltaTime) override {}
 
+    // Dense transforms also get a row in the TransformPool for batch updates
+    void SetDense(bool value);
+    bool IsDense() const { return handle.IsValid(); }
+    TransformHandle GetHandle() const { return handle; }
+
+private:
+    // Unused while the transform is dense
     Vector3 position = Vector3(0.0f, 0.0f, 0.0f);
     double rotation = 0.0f;
     Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
+    TransformHandle handle;
+};
+
+
+// One pre-rasterized cell of a sprite, as drawn by the camera
+struct SpriteCell {
+  Cell cell;             // Glyph and style written into the camera's frame buffer
+  bool visible = false;  // False for blank cells the camera skips
+};
+
+// Everything a sprite's cells depend on besides its asset
+struct SpriteRasterKey {
+  double rotation = 0;
+  Vector3 scale;
+  Vector2 pivot;
+  Vector2 pivotFactor;
+  bool useRelativePivot = true;
+
+  bool operator==(const SpriteRasterKey &other) const {
+    return rotation == other.rotation && scale == other.scale &&
+           pivot.x == other.pivot.x && pivot.y == other.pivot.y &&
+           pivotFactor.x == other.pivotFactor.x && pivotFactor.y == other.pivotFactor.y &&
+           useRelativePivot == other.useRelativePivot;
+  }
 };
 
+// Cells of a sprite for one SpriteRasterKey, row-major over GetPivotBounds()
+struct SpriteRaster {
+  std::vector<SpriteCell> cells;
+  int left = 0, top = 0;
+  int width = 0, height = 0;
+};
+
+// Parsed shape data. Assets are immutable and shared by every sprite showing
+// the same shape, so placing copies of a prefab copies a pointer. Changing a
+// sprite's shape swaps in another asset instead of editing this one.
+struct SpriteAsset {
+  std::string shape;                  // As given, markdown included
+  std::string cleanShape;             // Markdown and ANSI codes removed
+  std::vector<std::string> lines;     // cleanShape split on '\n'
+  std::vector<std::vector<std::string>> ansiExtracted; // Active SGR per cell
+  int width = 0, height = 0;          // Unscaled, unrotated
+
+  // Rasters built from this asset, shared between its sprites
+  std::shared_ptr<const SpriteRaster> FindRaster(const SpriteRasterKey &key) const;
+  void StoreRaster(const SpriteRasterKey &key, std::shared_ptr<const SpriteRaster> raster) const;
+
+private:
+  mutable std::mutex rasterMutex;
+  mutable std::vector<std::pair<SpriteRasterKey, std::shared_ptr<const SpriteRaster>>> rasters;
+};
+
+// What a sprite's cells are read from. Every part is immutable, so another
+// thread can keep reading it while the sprite changes.
+struct SpriteCellSource {
+  std::shared_ptr<const SpriteAsset> asset;
+  std::shared_ptr<const SpriteRaster> raster;
+  SpriteRasterKey key;
+
+  // Cells outside the raster are computed into scratch
+  const SpriteCell &GetCell(int column, int line, SpriteCell &scratch) const;
+};
+
+// Returns the shared asset for shape, parsing it on first use
+std::shared_ptr<const SpriteAsset> LoadSpriteAsset(const std::string &shape);
+// Builds an unshared asset from already cleaned lines and their SGR codes
+std::shared_ptr<const SpriteAsset> MakeSpriteAsset(const std::string &shape, const std::string &cleanShape,
+                                                   std::vector<std::vector<std::string>> ansiExtracted);
 
 class SpriteRenderer : public Component {
 public:
  std::shared_ptr<Component> Clone() const override {
-        return std::make_shared<SpriteRenderer>(*this); // Deep copy
+        // Shares the asset
+        return std::allocate_shared<SpriteRenderer>(PoolAllocator<SpriteRenderer>(), *this);
     }
 
   SpriteRenderer() {};
   explicit SpriteRenderer(std::string newShape) {
     setShape(newShape);
-    cleanShape = newShape;
 
     useRelativePivot = true;
     pivotFactor = Vector2(0.5f, 0.5f);  // Default pivot factor
@@ -108,7 +226,6 @@ public:
   // Constructor with shape and pivot
   SpriteRenderer(std::string newShape, Vector2 newPivot) {
     setShape(newShape);
-    cleanShape = newShape;
     pivot = newPivot;
   }
 
@@ -116,7 +233,6 @@ public:
   SpriteRenderer(bool useRelative, Vector2 newPivot, std::string newShape) {
     useRelativePivot = useRelative;
     setShape(newShape);
-    cleanShape = newShape;
     if(!useRelative) pivot = newPivot;
     else pivotFactor = newPivot;  // Default pivot factor
   }
@@ -124,7 +240,6 @@ public:
   // Constructor with shape, pivot, transparency, markdown, and color
   SpriteRenderer(bool useRelative, Vector2 newPivot, std::string newShape, bool transparent, bool markdown, Color newColor) {
     useRelativePivot = useRelative;
-    shape = newShape;
     setShape(newShape);
     if(!useRelative) pivot = newPivot;
     else pivotFactor = newPivot;  // Default pivot factor
@@ -149,48 +264,19 @@ public:
   Vector2 GetSize();
   Vector2 GetPivot();
   
-  SpriteRenderer(const SpriteRenderer& other)
-        : Component(other),
-          shape(other.shape),
-          cleanShape(other.cleanShape),
-          pivot(other.pivot),
-          pivotFactor(other.pivotFactor),
-          useRelativePivot(other.useRelativePivot),
-          isTransparent(other.isTransparent),
-          spriteColor(other.spriteColor),
-          useMarkdown(other.useMarkdown),
-          spriteWidth(other.spriteWidth),
-          spriteHeight(other.spriteHeight),
-          ansiExtracted(other.ansiExtracted) {
-       
-        ss = std::stringstream(other.ss.str());
-    }
-
-    SpriteRenderer& operator=(const SpriteRenderer& other) {
-        if (this != &other) {
-            Component::operator=(other);
-            shape = other.shape;
-            cleanShape = other.cleanShape;
-            pivot = other.pivot;
-            pivotFactor = other.pivotFactor;
-            useRelativePivot = other.useRelativePivot;
-            isTransparent = other.isTransparent;
-            spriteColor = other.spriteColor;
-            useMarkdown = other.useMarkdown;
-            spriteWidth = other.spriteWidth;
-            spriteHeight = other.spriteHeight;
-            ansiExtracted = other.ansiExtracted;
-
-            ss.str("");
-            ss.clear();
-            ss << other.ss.str();
-        }
-        return *this;
-    }
-  
   std::tuple<int, int, int, int> GetPivotBounds();
   std::string GetCellString(int column, int line);
   std::tuple<int, int, int, int> CalculatePivotExpansion();
+
+  // Picks up the raster for the current shape, rotation, scale and pivot,
+  // building it if no sprite sharing the asset has one yet
+  void UpdateCellCache();
+  // Returns the cached cell, computing it directly if it lies outside the cache.
+  // Call UpdateCellCache() first; the render loop does so once per sprite.
+  const SpriteCell& GetCell(int column, int line);
+  // Updates the cell cache and returns what the cells are read from
+  SpriteCellSource GetCellSource();
+
   void Update(float deltaTime) override {
     
   }
@@ -198,11 +284,14 @@ public:
   int spriteWidth = 0;
 private:
   Vector2 RotatePoint(double column, double line); //Helper function to rotate around the pivot
-  std::string shape = "";
-  std::string cleanShape = "";
-  
-  std::stringstream ss;
-  std::vector<std::vector<std::string>> ansiExtracted;
+  SpriteRasterKey GetRasterKey(); // From the current transform and pivot
+  const SpriteAsset &GetAsset() const;
+  void SetAsset(std::shared_ptr<const SpriteAsset> target);
+
+  std::shared_ptr<const SpriteAsset> asset;   // Null until a shape is set
+  std::shared_ptr<const SpriteRaster> raster; // Null until the first UpdateCellCache
+  SpriteRasterKey rasterKey;
+  SpriteCell uncachedCell; // Scratch cell for lookups outside the raster
 };
 
 std::string StripAnsi(const std::string& input) ;
@@ -211,67 +300,50 @@ std::vector<std::vector<std::string>> ExtractAnsi(const std::string& input);
 
 class Actor : public std::enable_shared_from_this<Actor>  {
 public:
-  std::string name;
-  
-  Actor(const Actor& other);
+  Actor(const Actor& other); // The copy is unplaced, its ID is -1
+  ~Actor();
 
 
- template <typename T, typename... Args>
-T* AddComponent(Args&&... args) {
+  template <typename T, typename... Args>
+  T *AddComponent(Args &&...args) {
     static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
 
     if (this == nullptr) {
-        std::cerr << "Error: Attempting to add component to a null Actor." << std::endl;
-        return nullptr;
+      std::cerr << "Error: Attempting to add component to a null Actor." << std::endl;
+      return nullptr;
     }
 
-    for (const auto& comp : objectComponents) {
-        if (std::dynamic_pointer_cast<T>(comp)) {
-            std::cerr << "Error: Component of type " << typeid(T).name() << " already exists." << std::endl;
-            return nullptr;
-        }
+    if (GetComponent<T>() != nullptr) {
+      std::cerr << "Error: Component of type " << typeid(T).name() << " already exists." << std::endl;
+      return nullptr;
     }
 
-
     // Now safe to create the component
     std::shared_ptr<T> component = std::make_shared<T>(this, std::forward<Args>(args)...);
-
-    // Perform any additional operations (like setting parent) if needed
-    component->UnsafeSetParent(this);
-
-    // Add component to objectComponents
-    objectComponents.push_back(component);
-
+    AttachComponent(component, ComponentTypeID<T>());
     return component.get(); // Return raw pointer to the component
-}
+  }
 
+  template <typename T>
+  T *AddComponent(std::shared_ptr<T> component) {
+    static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
 
-   template <typename T>
-T *AddComponent(std::shared_ptr<T> component) {
-    static_assert(std::is_base_of<Component, T>::value,
-                  "T must inherit from Component");
-    
     if (this == nullptr) {
-        std::cerr << "Error: Attempting to add component to a null Actor."
-                  << std::endl;
-        return nullptr;
+      std::cerr << "Error: Attempting to add component to a null Actor." << std::endl;
+      return nullptr;
     }
 
-    // Check if component of type T already exists
-    for (const auto &comp : objectComponents) {
-        if (std::dynamic_pointer_cast<T>(comp)) {
-            std::cerr << "Error: Component of type " << typeid(T).name()
-                      << " already exists." << std::endl;
-            return nullptr;
-        }
+    // The slot is picked by the component's own type, T may be a base class
+    size_t typeID = ComponentTypeID(typeid(*component));
+    if (typeID < componentSlots.size() && componentSlots[typeID] != nullptr) {
+      std::cerr << "Error: Component of type " << typeid(*component).name()
+                << " already exists." << std::endl;
+      return nullptr;
     }
 
-    // Call UnsafeSetParent before storing
-    component->UnsafeSetParent(this);
-
-    objectComponents.push_back(component);
+    AttachComponent(component, typeID);
     return component.get();
-}
+  }
 
   template <typename T> bool RemoveComponent() {
     static_assert(std::is_base_of<Component, T>::value,
@@ -282,27 +354,23 @@ T *AddComponent(std::shared_ptr<T> component) {
       return false; // Transform cannot be removed
     }
 
-    // Find and remove the component
-    auto it =
-        std::remove_if(objectComponents.begin(), objectComponents.end(),
-                       [](const std::shared_ptr<Component> &component) {
-                         return dynamic_cast<T *>(component.get()) != nullptr;
-                       });
-
-    if (it != objectComponents.end()) {
-      objectComponents.erase(
-          it, objectComponents.end()); // Remove all matched components
-      return true;                     // Removal successful
-    }
-
-    return false; // Removal failed (no component of the specified type found)
+    return DetachComponent(GetComponent<T>());
   }
-  
-  // Get a component of a specific type
+
+  // Get a component of a specific type. A component of exactly type T is
+  // found through the slot table; otherwise every component is scanned, so
+  // T may also be a base class of the component, abstract or not.
   template <typename T> T *GetComponent() const {
+    if (!std::is_abstract<T>::value) {
+      size_t typeID = ComponentTypeID<T>();
+      if (typeID < componentSlots.size() && componentSlots[typeID] != nullptr) {
+        return static_cast<T *>(componentSlots[typeID]);
+      }
+    }
+
     for (const auto &component : objectComponents) {
-      if (auto castedComponent = std::dynamic_pointer_cast<T>(component)) {
-        return castedComponent.get();
+      if (auto castedComponent = dynamic_cast<T *>(component.get())) {
+        return castedComponent;
       }
     }
     return nullptr;
@@ -356,7 +424,12 @@ T *AddComponent(std::shared_ptr<T> component) {
 
   std::map<std::string, int> intValues;
   std::map<std::string, std::string> stringValues;
-  std::string tag;
+
+  // The setters keep the tag and name indexes current
+  const std::string &GetTag() const { return tag; }
+  void SetTag(const std::string &value);
+  const std::string &GetName() const { return name; }
+  void SetName(const std::string &value);
 
   // Other member functions
 
@@ -365,12 +438,24 @@ T *AddComponent(std::shared_ptr<T> component) {
   void PlaceObjectAt(Vector3 location);
   void RemoveObject();
   
+  // Packs a slot index and a generation, see IsAlive
   int GetInstanceID() {
     return objectID;
   }
 private:
-  int objectID;
+  friend class Scheduler; // Walks componentSlots
+
+  std::shared_ptr<Actor> MakeInstance() const;
+  static int Place(const std::shared_ptr<Actor> &instance); // Returns the new ID
+
+  void AttachComponent(std::shared_ptr<Component> component, size_t typeID);
+  bool DetachComponent(Component *component);
+
+  std::string name;
+  std::string tag;
+  int objectID = -1; // -1 until placed in the Workspace
   std::vector<std::shared_ptr<Component>> objectComponents;    // Components of this Actor
+  std::vector<Component *> componentSlots; // Indexed by ComponentTypeID, null when absent
   std::shared_ptr<Actor> parent = nullptr; // Parent Actor
   std::vector<std::shared_ptr<Actor> > children;
 };
@@ -423,7 +508,7 @@ public:
     }
 
     std::shared_ptr<Component> Clone() const override {
-        return std::make_shared<UI>(*this); // Deep copy
+        return std::allocate_shared<UI>(PoolAllocator<UI>(), *this); // Deep copy
     }
   void Update(float deltaTime) {}
 };
@@ -432,6 +517,9 @@ void setNonBlockingMode(bool value);
 std::shared_ptr<Actor> InstanceIDToActor(int objID);
 
 
+// Instance IDs carry a generation, so an ID kept after its actor was
+// removed never matches the actor that reuses its slot. Both run without
+// a hash lookup.
 bool IsAlive(int obj);
 
 void SetCursorVisibility(bool value);
@@ -454,7 +542,11 @@ void SprayCircle(SPActor object, int spawns, const Vector3 &center, float radius
 
 int GetRandom(int min, int max);
 
-void applyFunction(const std::vector<int> &ids, std::function<void(int)> func,
+// Calls func for each live object on every PollEvents, on the shared thread
+// pool. Modes 'k' and 'm' only call it while the key (passed after mode) or
+// the mouse key is held. Stops once every object is gone, which key modes
+// only notice the next time their key is held.
+void ApplyFunction(const std::vector<int> &ids, std::function<void(int)> func,
                    char mode, ...);
 
 
@@ -463,14 +555,28 @@ void applyFunction(const std::vector<int> &ids, std::function<void(int)> func,
 
 std::vector<std::shared_ptr<Actor>> FindObjectsWithTag(const std::string tag);
 std::shared_ptr<Actor> FindObjectWithTag(const std::string tag);
+std::shared_ptr<Actor> FindObjectWithName(const std::string name);
+// Visits matches without building a vector. The callback may destroy the
+// actor it is given, but not other matching actors.
+void ForEachObjectWithTag(const std::string &tag, const std::function<void(const std::shared_ptr<Actor> &)> &func);
+void ForEachObjectWithName(const std::string &name, const std::function<void(const std::shared_ptr<Actor> &)> &func);
 
 void SetRawMode(bool value);
 
-Vector2 GetConsoleSize();
+Vector2 GetConsoleSize(); // Cached, see RefreshConsoleSize
+// Re-reads the console size, telling the surface's resize listeners if it
+// changed. PollEvents calls it once per frame.
+void RefreshConsoleSize();
 Vector2 GetConsoleCenter();
 
 void SetConsoleTitle(const std::string title);
 void Destroy(std::shared_ptr<Actor> actor);
+void Destroy(int objID);
+// Batch removal, returns the number of actors removed. The rect version
+// only sees actors with a SpriteRenderer (those in the spatial index) and
+// skips UI actors.
+int DestroyObjectsWithTag(const std::string tag);
+int DestroyObjectsInRect(const Rect &area);
 bool Gotoxy(int x, int y);
 double DeltaTime();
 void Clear();
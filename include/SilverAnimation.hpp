@@ -40,6 +40,7 @@ public:
     void ResumeAnimation();
     
     void Update(float deltaTime) {
+      if (playing == nullptr) return; // The Scheduler updates idle managers too
       static double elapsedTime = 0.0f;
       double interval = 1000 / playing->fps;
       elapsedTime += DeltaTime();
@@ -1,6 +1,90 @@
 #include "Silver.hpp"
 
 #include <atomic>
+#include <memory>
+#include <tuple>
+
+// Output counters for the last presented frame
+struct FrameStats {
+  size_t bytes = 0; // Bytes sent to the console
+  int writes = 0;   // Write calls (syscalls) used to send them
+};
+
+// One sprite as the camera saw it when the snapshot was taken
+struct SpriteDraw {
+  int id = -1;
+  Vector3 position; // Transform position, not rounded
+  Vector2 pivot;
+  std::tuple<int, int, int, int> bounds; // GetPivotBounds()
+  SpriteCellSource cells;
+};
+
+// Back to front order of the sprites a camera draws, kept between frames.
+// Sprites whose key did not change keep their place, so only added or
+// moved ones are sorted and a frame where no depth changed sorts nothing.
+class DrawOrder {
+public:
+  struct Key {
+    int id;
+    bool isUI;    // UI is drawn over everything else
+    double depth; // position.z - |scale.z| / 2, flipped with the view
+  };
+
+  // keys must be in ascending id order. Returns indices into keys, back
+  // to front, valid until the next call.
+  const std::vector<int> &Update(const std::vector<Key> &keys);
+  size_t GetSortedCount() const { return sortedCount; } // Keys sorted by the last Update
+
+private:
+  std::vector<Key> previous;
+  std::vector<int> order;
+  std::vector<int> previousToCurrent, kept, fresh; // Scratch
+  size_t sortedCount = 0;
+};
+
+// A line of a text overlay, decoded once
+struct TextLine {
+  std::vector<Cell> cells; // One per column
+  int x = 0;               // First column in the frame buffer
+};
+
+// The camera's text overlays split into lines and placed around the view.
+// Built again only when a text, an align value or the view size changes,
+// and never edited afterwards, so snapshots share it.
+struct TextLayout {
+  std::string topText, bottomText, leftText, rightText; // Source texts
+  std::vector<TextLine> top, bottom, left, right;
+  int maxLeftWidth = 0, maxRightWidth = 0;
+
+  // What the lines were placed for
+  double viewWidth = -1, viewHeight = -1;
+  double topAlign = 0, bottomAlign = 0, leftAlign = 0, rightAlign = 0;
+  int leftRow = 0, rightRow = 0; // View row of the first left and right line
+};
+
+// Everything needed to draw one frame, copied out of the camera and the
+// Workspace on the game thread. The render thread reads nothing else.
+struct RenderSnapshot {
+  bool visible = false; // False when the view has no area
+  int consoleWidth = 0, consoleHeight = 0;
+  Vector3 cameraScale, cameraDisplayPosition; // Resolved against the console
+  Vector3 position;
+  double rotation = 0;
+  Vector2 anchor;
+
+  std::string backgroundPattern;
+  Vector2 patternOccurrenceRate;
+  bool showOutOfStagePatterns = false;
+
+  std::shared_ptr<const TextLayout> text;
+  bool sideLimit = false;
+
+  bool drawMouse = false;
+  int mouseX = 0, mouseY = 0;
+  std::string mouseIcon;
+
+  std::vector<SpriteDraw> sprites; // Culled, back to front
+};
 
 class Camera : public Component {
 public:
@@ -39,7 +123,9 @@ public:
       anchor = other.anchor;
       cameraRect = other.cameraRect;
       scale = other.scale;
+      surface = std::atomic_load(&other.surface);
   }
+  ~Camera(); // Stops a running shake
 
   // Assignment operator
   Camera& operator=(const Camera& other) {
@@ -68,10 +154,11 @@ public:
           hideMouse = other.hideMouse;
           lastFrame = other.lastFrame;
           isRunningCam = other.isRunningCam.load();
-          displayPosition = other.displayPosition;
+              displayPosition = other.displayPosition;
           anchor = other.anchor;
           cameraRect = other.cameraRect;
           scale = other.scale;
+          surface = std::atomic_load(&other.surface);
       }
       return *this;
   }
@@ -103,23 +190,39 @@ public:
 
   Vector3 position;
   double rotation;
-  
-  
-  CRITICAL_SECTION bufferMutex;
 
   bool hideMouse = true;
-  std::map<std::tuple<int, int>, std::string> lastFrame;
+  FrameBuffer lastFrame; // Last presented frame, the next one is diffed against it
   std::atomic<bool> isRunningCam{false};
- 
-  CRITICAL_SECTION camMutex;
-  
+
+  // Captures and draws a frame on the calling thread. A running camera is
+  // drawn by the video thread, so for it this only publishes a snapshot.
   void RenderFrame();
+  // Game thread: copies what the camera sees for the video thread.
+  // WorkspaceScheduler.Tick does this for every running camera.
+  void PublishSnapshot();
+  // Video thread: draws the newest published snapshot if it was not drawn
+  // yet. Returns false if nothing was ever published. This is the only way
+  // the video thread draws, it never reads the Workspace.
+  bool DrawLatestSnapshot();
   void StartVideo();
   void StopVideo();
   Vector2 GetScreenPosition(Vector3 pos);
   void ShakeCameraOnce(float intensity);
+  // While scripts are being updated (see AreScriptsUpdating) this returns
+  // at once and the shakes run as a script on the engine tick. Otherwise it
+  // shakes on the calling thread and returns when done, publishing a
+  // snapshot after each shake if the camera is running.
+  // delayBetweenShakes is in milliseconds.
   void ShakeCamera(float intensity, int shakes, float delayBetweenShakes);
+  void StopShake(); // Ends a running shake where it started
   void EraseCamera();
+  void InvalidateFrame(); // Redraw every cell on the next frame
+  FrameStats GetFrameStats() const { return frameStats; }
+
+  // Renders to target instead of the global terminal surface, nullptr undoes it
+  void SetSurface(std::shared_ptr<TerminalSurface> target);
+  std::shared_ptr<TerminalSurface> GetSurface();
   
   Rect getCameraZone();
   Vector3 getScale();
@@ -130,9 +233,64 @@ public:
   }
 
 private:
+  void CaptureSnapshot(RenderSnapshot &snapshot);
+  void DrawSnapshot(const RenderSnapshot &snapshot);
+  void DrawBand(const RenderSnapshot &snapshot, int top, int bottom);
+  void UpdatePatternLayer(const RenderSnapshot &snapshot, int viewWidth);
+  void UpdateTextLayout(int consoleWidth, int consoleHeight, Vector3 &cameraScale);
+  void PresentFrame(TerminalSurface &target, int offsetX, int offsetY, int consoleWidth, int consoleHeight);
+
+  FrameBuffer frameBuffer;  // Reused across frames, resized with the view
+  std::string frameOutput;  // Bytes of the frame being presented, reused
+  FrameStats frameStats;
+  std::vector<int> visibleIDs; // Reused for the spatial index query
+  std::shared_ptr<const TextLayout> textLayout; // Game thread side, see UpdateTextLayout
+  std::vector<SpriteDraw> culled;          // Visible sprites in id order
+  std::vector<DrawOrder::Key> culledKeys;  // Their draw keys
+  DrawOrder drawOrder;
+
+  SnapshotBuffer<RenderSnapshot> snapshots; // Game thread to video thread
+  RenderSnapshot frameSnapshot;             // Used by RenderFrame
+  bool hasSnapshot = false;                 // Video thread has acquired one
+  std::vector<Vector2> drawCorners;         // Top left, bottom right of each drawn sprite
+
+  // Background rows for the current view width, see UpdatePatternLayer
+  struct PatternLayer {
+    std::string pattern;
+    int rateX = 0, rateY = 0;
+    int width = -1;
+    std::vector<Cell> patternRow, blankRow;
+  };
+  PatternLayer patternLayer;
+
+  // Own render target, if any. Read by the video thread, so only touched
+  // through std::atomic_load and std::atomic_store.
+  std::shared_ptr<TerminalSurface> surface;
+  int shakeScript = -1;
+  Vector3 shakeOrigin;
+  int previousConsoleWidth = 0, previousConsoleHeight = 0;
+
+  // Where lastFrame was drawn; it is only diffed against while this holds
+  int lastFrameX = 0, lastFrameY = 0;
+  unsigned lastFrameClears = 0;
+  std::atomic<bool> lastFrameValid{false}; // Cleared from the game thread
+
   Vector2 displayPosition = Vector2(0, 0);
   Vector2 anchor = Vector2(0, 0);
   Rect cameraRect = Rect(0, 0, 1, 1);
   Vector3 scale = Vector3(20, 20, 20);
 };
 
+// Publishes a snapshot for every running camera. WorkspaceScheduler.Tick
+// calls it once per tick, after the steps; a game loop that does not tick
+// the scheduler calls it once per frame instead.
+void PublishRenderSnapshots();
+
+// Views with at least this many cells are drawn in row bands on the thread
+// pool when the machine has more than one hardware thread; smaller ones are
+// drawn on the calling thread. The default of 4096 cells (a 200x60 console
+// is 12000) is not measured on multi-core hardware: run
+// benchmarks/CameraScalingBenchmark on the target machine and set the
+// smallest size where banding wins. 0 bands every view.
+void SetParallelRenderCells(int cells);
+int GetParallelRenderCells();
@@ -0,0 +1,70 @@
+#ifndef SILVER_EVENTS_HPP
+#define SILVER_EVENTS_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+enum class InputEventType {
+  KeyDown,    // Pressed since the previous poll
+  KeyUp,      // Released since the previous poll
+  KeyHeld,    // Down during this poll, sent every poll
+  CursorMove, // The virtual mouse cursor moved since the previous poll
+  Frame       // Once per poll, after the others
+};
+
+struct InputEvent {
+  InputEventType type;
+  int key;                // -1 for cursor and frame events
+  int cursorX, cursorY;   // Cursor position at the poll
+};
+
+using InputCallback = std::function<void(const InputEvent &)>;
+
+// Delivers the events PollEvents publishes to whoever subscribed to them.
+// Nothing runs between polls, so waiting on input costs nothing.
+//
+// Callbacks run on the thread calling PollEvents unless subscribed with
+// onPool, in which case they are queued on the shared thread pool. A pool
+// callback that is still running when its event comes again skips that
+// event rather than running twice at once.
+class InputBus {
+public:
+  // key -1 matches every key. Returns an ID for Unsubscribe.
+  int Subscribe(InputEventType type, int key, InputCallback callback, bool onPool = false);
+  void Unsubscribe(int id); // Safe from inside a callback
+  void Clear();
+
+  bool HasSubscribers(InputEventType type) const;
+  size_t GetSubscriptionCount();
+
+  void Publish(const InputEvent &event);
+
+private:
+  struct Subscription {
+    int id;
+    int bucket;
+    InputCallback callback;
+    bool onPool;
+    std::atomic<bool> active{true};
+    std::atomic<bool> busy{false};
+  };
+
+  static int BucketKey(InputEventType type, int key) {
+    return static_cast<int>(type) << 16 | (key & 0xffff);
+  }
+  void Collect(int bucket, std::vector<std::shared_ptr<Subscription>> &out);
+
+  std::mutex busMutex;
+  std::unordered_map<int, std::vector<std::shared_ptr<Subscription>>> buckets;
+  std::unordered_map<int, int> subscriptionBuckets; // ID to bucket
+  std::atomic<int> typeCounts[5] = {};
+  int nextID = 0;
+};
+
+extern InputBus InputEvents; // Fed by PollEvents
+
+#endif
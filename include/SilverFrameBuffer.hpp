@@ -0,0 +1,75 @@
+#ifndef SILVER_FRAMEBUFFER_HPP
+#define SILVER_FRAMEBUFFER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cell flags
+enum CellFlags : uint8_t {
+  CELL_SKIP = 1, // Nothing was drawn here, the console keeps what it shows
+  CELL_RAW = 2   // The codepoint is a raw byte and is written out unencoded
+};
+
+// One console cell. Kept trivially copyable so rows can be copied in bulk.
+struct Cell {
+  char32_t codepoint = U' ';
+  uint16_t style = 0; // Index into the style table, 0 is the terminal default
+  uint8_t flags = CELL_SKIP;
+
+  bool operator==(const Cell &other) const {
+    return codepoint == other.codepoint && style == other.style &&
+           flags == other.flags;
+  }
+  bool operator!=(const Cell &other) const { return !(*this == other); }
+};
+
+// Row-major grid of cells, reused across frames
+class FrameBuffer {
+public:
+  // Keeps the allocation when the size does not change
+  void Resize(int width, int height);
+  void Fill(const Cell &cell);
+
+  int GetWidth() const { return width; }
+  int GetHeight() const { return height; }
+
+  Cell &At(int x, int y) { return cells[y * width + x]; }
+  const Cell &At(int x, int y) const { return cells[y * width + x]; }
+  Cell *Row(int y) { return &cells[y * width]; }
+  const Cell *Row(int y) const { return &cells[y * width]; }
+
+  bool Contains(int x, int y) const {
+    return x >= 0 && x < width && y >= 0 && y < height;
+  }
+
+  // Writes UTF-8 text with embedded SGR sequences starting at (x, y).
+  // Cells outside the buffer or past maxCells are dropped.
+  // Returns the number of cells the text occupies.
+  int WriteText(int x, int y, const std::string &text, int maxCells = -1);
+  // Same for text already decoded with DecodeText
+  void WriteCells(int x, int y, const std::vector<Cell> &text);
+
+private:
+  int width = 0;
+  int height = 0;
+  std::vector<Cell> cells;
+};
+
+// Style table shared by every buffer. A style is the SGR sequence that
+// selects it, and style 0 is the empty sequence.
+uint16_t InternStyle(const std::string &sequence);
+const std::string &GetStyleSequence(uint16_t style);
+
+// Cell helpers
+Cell MakeCell(char glyph, uint16_t style = 0);
+// Decodes the UTF-8 glyph at text[i] and advances i past it. Invalid or
+// truncated sequences come back as a single raw byte.
+Cell DecodeCell(const std::string &text, size_t &i, uint16_t style = 0);
+Cell ParseCell(const std::string &cellString); // "<SGR...>glyph<reset>" form
+void AppendGlyph(std::string &out, const Cell &cell); // UTF-8 encodes the glyph
+int TextWidth(const std::string &text); // Cells taken, SGR sequences excluded
+// The cells WriteText would write for text, one per glyph
+std::vector<Cell> DecodeText(const std::string &text);
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SILVER_INPUT_HPP
+#define SILVER_INPUT_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+// One bit per virtual key code
+struct KeySet {
+  uint64_t words[4] = {0, 0, 0, 0};
+
+  bool Test(int key) const {
+    return key >= 0 && key < 256 && (words[key >> 6] >> (key & 63) & 1) != 0;
+  }
+  void Set(int key, bool value) {
+    if (key < 0 || key >= 256) return;
+    uint64_t bit = uint64_t(1) << (key & 63);
+    words[key >> 6] = value ? words[key >> 6] | bit : words[key >> 6] & ~bit;
+  }
+  bool Any() const { return (words[0] | words[1] | words[2] | words[3]) != 0; }
+
+  KeySet operator&(const KeySet &other) const {
+    KeySet result;
+    for (int i = 0; i < 4; i++) result.words[i] = words[i] & other.words[i];
+    return result;
+  }
+  KeySet operator~() const {
+    KeySet result;
+    for (int i = 0; i < 4; i++) result.words[i] = ~words[i];
+    return result;
+  }
+  bool operator==(const KeySet &other) const {
+    return words[0] == other.words[0] && words[1] == other.words[1] &&
+           words[2] == other.words[2] && words[3] == other.words[3];
+  }
+  bool operator!=(const KeySet &other) const { return !(*this == other); }
+};
+
+// Everything PollEvents reads in one poll
+struct InputFrame {
+  KeySet keys;
+  int cursorX = 0, cursorY = 0;
+};
+
+// Where PollEvents gets its input from
+class InputSource {
+public:
+  virtual ~InputSource() = default;
+
+  // Fills frame for this poll. frame arrives holding the current cursor.
+  virtual void Read(InputFrame &frame) = 0;
+  // False when the cursor comes from the virtual mouse stepping on keys
+  virtual bool ProvidesCursor() const { return false; }
+};
+
+// The keyboard, through GetAsyncKeyState. Windows only, elsewhere no key
+// reads as pressed.
+class LiveInputSource : public InputSource {
+public:
+  void Read(InputFrame &frame) override;
+};
+
+// Plays back a log written by StartInputRecording, one frame per poll.
+// After the last frame every key reads as released.
+class ReplayInputSource : public InputSource {
+public:
+  explicit ReplayInputSource(const std::string &path);
+
+  bool IsOpen() const { return isOpen; }
+  bool IsFinished() const { return finished; }
+  uint64_t GetFramesRead() const { return framesRead; }
+
+  void Read(InputFrame &frame) override;
+  bool ProvidesCursor() const override { return true; }
+
+private:
+  std::ifstream file;
+  InputFrame last;
+  bool isOpen = false;
+  bool finished = false;
+  uint64_t framesRead = 0;
+};
+
+// nullptr restores the live keyboard
+void SetInputSource(std::shared_ptr<InputSource> source);
+std::shared_ptr<InputSource> GetInputSource();
+
+// Logs every polled frame to path until stopped. Frames cost one byte
+// when nothing changed since the previous one.
+bool StartInputRecording(const std::string &path);
+void StopInputRecording();
+bool IsRecordingInput();
+void RecordInputFrame(const InputFrame &frame); // Called by PollEvents
+
+#endif
@@ -1,55 +1,81 @@
 #ifndef SILVER_KEYBOARD_HPP
 #define SILVER_KEYBOARD_HPP
 
-#include <windows.h>
-#include <unordered_map>
+#include "SilverInput.hpp"
 
-// Virtual key codes (Windows VK_* codes)
-#define KEY_UP VK_UP
-#define KEY_DOWN VK_DOWN
-#define KEY_LEFT VK_LEFT
-#define KEY_RIGHT VK_RIGHT
+#include <cstdint>
+#include <vector>
+
+// Virtual key codes, the values of the Windows VK_* codes, spelled out so
+// this header does not need <windows.h>
+#define KEY_UP 0x26
+#define KEY_DOWN 0x28
+#define KEY_LEFT 0x25
+#define KEY_RIGHT 0x27
 
 // Function Keys
-#define KEY_F1 VK_F1
-#define KEY_F2 VK_F2
-#define KEY_F3 VK_F3
-#define KEY_F4 VK_F4
-#define KEY_F5 VK_F5
-#define KEY_F6 VK_F6
-#define KEY_F7 VK_F7
-#define KEY_F8 VK_F8
-#define KEY_F9 VK_F9
-#define KEY_F10 VK_F10
-#define KEY_F11 VK_F11
-#define KEY_F12 VK_F12
+#define KEY_F1 0x70
+#define KEY_F2 0x71
+#define KEY_F3 0x72
+#define KEY_F4 0x73
+#define KEY_F5 0x74
+#define KEY_F6 0x75
+#define KEY_F7 0x76
+#define KEY_F8 0x77
+#define KEY_F9 0x78
+#define KEY_F10 0x79
+#define KEY_F11 0x7A
+#define KEY_F12 0x7B
 
 // Escape Keys
-#define KEY_ESC VK_ESCAPE
+#define KEY_ESC 0x1B
 
 // Backspace and Delete Keys
-#define KEY_BACKSPACE VK_BACK
-#define KEY_DELETE VK_DELETE
+#define KEY_BACKSPACE 0x08
+#define KEY_DELETE 0x2E
 
 // Other special keys
-#define KEY_ENTER VK_RETURN
-#define KEY_SPACE VK_SPACE
+#define KEY_ENTER 0x0D
+#define KEY_SPACE 0x20
+
+// A key going down or up, as seen by PollEvents
+struct KeyTransition {
+  int64_t timestamp; // steady_clock nanoseconds
+  uint8_t key;
+  bool down;
+};
 
-static std::unordered_map<int, bool> keyStates;
-static std::unordered_map<int, bool> keyDownStates;
-static std::unordered_map<int, bool> keyUpStates;
-static bool isInitialized;
+// Cost of PollEvents, in microseconds
+struct PollStats {
+  double last = 0;
+  double average = 0; // Over every poll so far
+  double max = 0;
+  uint64_t polls = 0;
+  uint64_t droppedTransitions = 0; // Lost to a full transition ring
+};
 
 // Initializes the keyboard input system
 void InitializeKeyboardModule();
 
-// Polls keyboard state (call once per frame)
+// Reads a frame from the input source, steps the virtual mouse and
+// publishes the changes to InputEvents (call once per frame)
 void PollEvents();
 
-// Key state checkers
+// Key state checkers, safe from any thread
 bool IsKey(int key);     // Checks if a key is currently pressed
 bool IsKeyDown(int key); // Checks if a key was pressed this frame
 bool IsKeyUp(int key);   // Checks if a key was released this frame
 
+KeySet GetKeyStates();
+KeySet GetKeysDown();
+KeySet GetKeysUp();
+
+// Moves the transitions recorded since the last call into out, oldest
+// first. The ring holds 1024, further ones are dropped until it is
+// drained. Only one thread may drain.
+size_t DrainKeyTransitions(std::vector<KeyTransition> &out);
+
+PollStats GetPollStats();
+
 
 #endif // SILVER_KEYBOARD_HPP
\ No newline at end of file
@@ -1,11 +1,12 @@
 #ifndef SILVER_MUSIC_HPP
 #define SILVER_MUSIC_HPP
 
-#include <windows.h>
-#include <mmsystem.h>
 #include <string>
 #include <memory>
 
+// Plays WAV files through the Windows waveOut API. Only built on Windows;
+// the device handles stay in the source file so this header has no
+// <windows.h> dependency.
 class AudioPlayer {
 public:
     explicit AudioPlayer(const std::string& filePath);
@@ -13,17 +14,15 @@ public:
 
     void Play();  // Synchronous playback
     void Stop();
-    void SetVolume(DWORD newVolume);  // 0-1000 scale
+    void SetVolume(unsigned long newVolume);  // 0-1000 scale
     void Pause();
     void Resume();
 
 private:
+    struct Device; // waveOut handle, format and loaded samples
+
     std::string filePath;
-    HWAVEOUT hWaveOut;
-    WAVEFORMATEX waveFormat;
-    WAVEHDR waveHeader;
-    std::unique_ptr<BYTE[]> audioData;
-    DWORD dataSize;
+    std::unique_ptr<Device> device;
     bool isPlaying;
     bool isPaused;
 
@@ -0,0 +1,104 @@
+#ifndef SILVER_POOL_HPP
+#define SILVER_POOL_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Free list of fixed size blocks carved out of larger chunks. Released
+// blocks are reused by the next allocation, so spawn and despawn churn stays
+// off the global heap. Chunks are kept until the program exits.
+//
+// PoolAllocator goes through a per-thread BlockList instead of Allocate and
+// Release, and only locks the pool to move a batch of blocks at a time.
+class BlockPool {
+public:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+  // A thread's own free blocks, see GetBlockCache
+  struct BlockList {
+    FreeBlock *head;
+    size_t count;
+  };
+
+  explicit BlockPool(size_t blockSize);
+
+  void *Allocate();
+  void Release(void *block);
+  void Refill(BlockList &list, size_t count); // Moves count blocks onto list
+  void Drain(BlockList &list, size_t count);  // Moves count blocks back from list
+
+  size_t GetBlockSize() const { return blockSize; }
+  size_t GetLiveBlocks(); // Not in the shared free list, thread caches included
+
+private:
+  FreeBlock *Pop(); // Carves a new chunk when the free list is empty
+
+  std::mutex poolMutex;
+  FreeBlock *freeList = nullptr;
+  std::vector<char *> chunks;
+  size_t blockSize;
+  size_t liveBlocks = 0;
+};
+
+// One pool per block size. Never destroyed, so objects released during
+// static destruction can still hand their blocks back.
+template <size_t Size, size_t Align> BlockPool &GetBlockPool() {
+  static_assert(Align <= alignof(std::max_align_t), "Over-aligned types are not pooled");
+  static BlockPool *pool = new BlockPool((Size + Align - 1) / Align * Align);
+  return *pool;
+}
+
+// Blocks a thread cache takes from or gives back to its pool at a time. A
+// cache holds at most twice this many.
+static const size_t blockCacheBatch = 32;
+
+// The calling thread's free blocks for one pool. Trivially destructible, so
+// it is still usable during static destruction; the blocks of a thread that
+// exits stay with it, at most 2 * blockCacheBatch per size.
+template <size_t Size, size_t Align> BlockPool::BlockList &GetBlockCache() {
+  static thread_local BlockPool::BlockList cache = {nullptr, 0};
+  return cache;
+}
+
+// Standard allocator backed by GetBlockPool. Meant for std::allocate_shared,
+// which rebinds it to the control block type so object and count share a block.
+template <typename T> struct PoolAllocator {
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U> PoolAllocator(const PoolAllocator<U> &) {}
+
+  T *allocate(size_t count) {
+    if (count != 1) return static_cast<T *>(::operator new(count * sizeof(T)));
+    BlockPool::BlockList &cache = GetBlockCache<sizeof(T), alignof(T)>();
+    if (cache.head == nullptr) GetBlockPool<sizeof(T), alignof(T)>().Refill(cache, blockCacheBatch);
+    BlockPool::FreeBlock *block = cache.head;
+    cache.head = block->next;
+    cache.count--;
+    return reinterpret_cast<T *>(block);
+  }
+
+  void deallocate(T *block, size_t count) {
+    if (count != 1) {
+      ::operator delete(block);
+      return;
+    }
+    BlockPool::BlockList &cache = GetBlockCache<sizeof(T), alignof(T)>();
+    BlockPool::FreeBlock *freed = reinterpret_cast<BlockPool::FreeBlock *>(block);
+    freed->next = cache.head;
+    cache.head = freed;
+    if (++cache.count >= 2 * blockCacheBatch) {
+      GetBlockPool<sizeof(T), alignof(T)>().Drain(cache, blockCacheBatch);
+    }
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) { return true; }
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) { return false; }
+
+#endif
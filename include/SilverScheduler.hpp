@@ -0,0 +1,89 @@
+#ifndef SILVER_SCHEDULER_HPP
+#define SILVER_SCHEDULER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Actor;
+class Component;
+
+enum class StepMode {
+  Variable, // One step per tick, as long as the time since the last tick
+  Fixed     // As many fixed-length steps as the elapsed time covers
+};
+
+// Time one component type spent in Update during the last tick
+struct SystemTiming {
+  const char *name = "";   // typeid name of the component type
+  size_t typeID = 0;       // ComponentTypeID, or one of the IDs below
+  size_t calls = 0;        // Summed over the tick's steps
+  bool parallel = false;   // Ran on the thread pool
+  double milliseconds = 0;
+};
+
+static const size_t scriptTimingID = static_cast<size_t>(-1); // UpdateScripts
+static const size_t timerTimingID = static_cast<size_t>(-2);  // WorkspaceTimers
+
+// Drives Component::Update for every component of every Workspace actor.
+// Each step walks the component types in ComponentTypeID order and updates
+// all components of one type before moving to the next, then fires the
+// WorkspaceTimers that came due and runs UpdateScripts. Types whose
+// IsIndependent() returns true are split across the shared thread pool;
+// the rest run on the thread calling Tick.
+//
+// After the steps, every running camera publishes a snapshot for the video
+// thread (see Camera::PublishSnapshot).
+//
+// Components and actors are gathered once per tick. Components removed
+// during the tick are skipped, ones added are picked up by the next tick.
+class Scheduler {
+public:
+  Scheduler() = default;
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  void SetStepMode(StepMode mode);
+  StepMode GetStepMode() const { return stepMode; }
+  void SetFixedStep(double seconds); // 1/60 by default
+  double GetFixedStep() const { return fixedStep; }
+  void SetMaxSteps(int steps); // Fixed steps per tick before the backlog is dropped
+
+  // Advances by the time since the previous Tick, zero on the first call.
+  // Returns the number of steps run.
+  int Tick();
+  int Tick(double deltaTime); // deltaTime in seconds
+
+  // Part of a fixed step left over after the last tick, from 0 to 1
+  double GetStepAlpha() const;
+
+  const std::vector<SystemTiming> &GetTimings() const { return timings; }
+  double GetTickMilliseconds() const { return tickMilliseconds; } // Gathering included
+
+private:
+  struct Entry {
+    Actor *actor;
+    Component *component;
+  };
+
+  void Gather();
+  void Step(float deltaTime);
+  static void RunEntries(const Entry *entries, size_t count, size_t typeID, float deltaTime);
+
+  StepMode stepMode = StepMode::Variable;
+  double fixedStep = 1.0 / 60;
+  int maxSteps = 5;
+  double accumulator = 0;
+  bool ticked = false;
+  std::chrono::steady_clock::time_point lastTick;
+
+  std::vector<std::shared_ptr<Actor>> actors; // Kept alive through the tick
+  std::vector<std::vector<Entry>> groups;     // Indexed by ComponentTypeID, reused
+  std::vector<SystemTiming> timings;
+  double tickMilliseconds = 0;
+};
+
+extern Scheduler WorkspaceScheduler; // Updates the Workspace
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SILVER_SCRIPT_HPP
+#define SILVER_SCRIPT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// A timed behaviour written as a list of steps, resumed once per tick by
+// UpdateScripts instead of sleeping on a thread of its own:
+//
+//   Script patrol;
+//   patrol.Do([=] { Move(guard, 1); }).WaitSeconds(0.5).Loop();
+//   RunScript(patrol, guard);
+//
+// The steps are shared by every run of the same Script, so a running
+// script only keeps its position, timer and loop count.
+class Script {
+public:
+  Script &Do(std::function<void()> action);
+  Script &WaitSeconds(double seconds);
+  Script &NextFrame();
+  Script &WaitUntil(std::function<bool()> condition); // Checked once per tick
+  // Runs the steps since the previous Loop, or since the start, again.
+  // times is the number of repeats, -1 repeats forever.
+  Script &Loop(int times = -1);
+
+  size_t GetStepCount() const { return steps ? steps->size() : 0; }
+
+  // Read by the runner in SilverScript.cpp
+  struct Step {
+    enum Kind { Action, Wait, Frame, Until, Repeat } kind;
+    std::function<void()> action;
+    std::function<bool()> condition;
+    double seconds = 0;
+    int times = 0;
+    size_t loopStart = 0; // Repeat jumps back here
+  };
+
+private:
+  friend int RunScript(const Script &script, int actorID);
+
+  Script &Add(Step step);
+
+  std::shared_ptr<std::vector<Step>> steps;
+  size_t loopStart = 0;
+};
+
+// Starts script and returns its ID. With an actor ID, the script stops by
+// itself once that actor is gone.
+int RunScript(const Script &script, int actorID = -1);
+void StopScript(int id); // Safe from inside a step
+bool IsScriptRunning(int id);
+size_t GetScriptCount();
+
+// Advances every running script. WorkspaceScheduler.Tick calls it once per
+// step; call it directly when the scheduler is not used. Game thread only.
+void UpdateScripts(double deltaTime);
+// True if UpdateScripts ran within the last second, so a script started now
+// will be advanced. Engine calls that fall back to blocking when nothing
+// drives scripts, like Camera::ShakeCamera, check this.
+bool AreScriptsUpdating();
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SILVER_SNAPSHOT_HPP
+#define SILVER_SNAPSHOT_HPP
+
+#include <atomic>
+
+// Hands the newest T from one producer thread to one consumer thread
+// without locks. Three slots rotate: the producer fills its back slot and
+// swaps it into the middle, the consumer swaps the middle out for its front
+// slot when it holds something newer. Neither side ever waits, each only
+// touches the slot it owns, and the slots are reused so their storage is
+// kept from one publish to the next.
+//
+//   producer: Fill(buffer.GetBack()); buffer.Publish();
+//   consumer: if (buffer.Acquire()) Use(buffer.GetFront());
+template <typename T> class SnapshotBuffer {
+public:
+  SnapshotBuffer() = default;
+  SnapshotBuffer(const SnapshotBuffer &) = delete;
+  SnapshotBuffer &operator=(const SnapshotBuffer &) = delete;
+
+  // Producer side
+  T &GetBack() { return slots[back]; }
+  void Publish() {
+    back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+  }
+
+  // Consumer side. Returns false, and keeps the front slot, when nothing
+  // was published since the last call.
+  bool Acquire() {
+    if (!(middle.load(std::memory_order_acquire) & freshBit)) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+    return true;
+  }
+  const T &GetFront() const { return slots[front]; }
+
+private:
+  static constexpr unsigned indexMask = 3;
+  static constexpr unsigned freshBit = 4; // Set while the middle slot is unread
+
+  T slots[3];
+  unsigned back = 0, front = 1;
+  std::atomic<unsigned> middle{2};
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SILVER_SPATIAL_HPP
+#define SILVER_SPATIAL_HPP
+
+#include "smath.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over the Workspace used by cameras to find what they can see.
+// Every placed actor with a SpriteRenderer is filed under each grid cell its
+// bounds overlap. UI actors are drawn relative to the camera, so they are
+// kept in a separate list and returned by every query.
+//
+// Changes are applied lazily: Insert and MarkDirty only queue the id, and
+// the next Query re-reads the queued actors' bounds.
+class SpatialIndex {
+public:
+  explicit SpatialIndex(int cellSize = 16);
+
+  void Insert(int id);
+  void Remove(int id);
+  void Remove(const std::vector<int> &ids);
+  void MarkDirty(int id); // Ignored for ids that are not indexed
+  void MarkDirty(const std::vector<int> &ids);
+  void Clear();
+
+  // Fills out with the ids, in ascending order, of every UI actor and every
+  // actor whose bounds may overlap area. Callers still do the exact test.
+  void Query(const Rect &area, std::vector<int> &out);
+
+  // Half of the widest or tallest actor indexed so far, never shrinks.
+  // Lets rotated views pad their query enough to stay conservative.
+  double GetLargestExtent();
+
+  int GetCellSize() const { return cellSize; }
+  size_t Size();
+
+private:
+  struct Entry {
+    int minX = 0, minY = 0, maxX = 0, maxY = 0; // Covered grid cells
+    bool inGrid = false;
+    bool isUI = false;
+    bool dirty = false;
+    unsigned queryStamp = 0;
+  };
+
+  void Refresh(int id, Entry &entry);
+  void Unlink(int id, Entry &entry);
+  void FlushDirty();
+  int CellCoord(double value) const;
+  static uint64_t CellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+  }
+
+  int cellSize;
+  std::unordered_map<uint64_t, std::vector<int>> cells;
+  std::unordered_map<int, Entry> entries;
+  std::vector<int> uiActors;
+  std::vector<int> dirty;
+  unsigned queryStamp = 0;
+  double largestExtent = 0;
+  std::mutex indexMutex;
+};
+
+extern SpatialIndex WorkspaceIndex; // Tracks every actor in Workspace
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SILVER_TAGS_HPP
+#define SILVER_TAGS_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Small integer IDs for tags, so the TransformPool's batch loops compare
+// ints. The empty string is 0. IDs are never released, so this table grows
+// with every distinct tag ever interned; names are never put in it.
+int InternTag(const std::string &tag);
+int FindTagID(const std::string &tag); // -1 if the string was never interned
+
+// Maps a key (a tag or a name) to the IDs of the placed actors that carry
+// it. Buckets are swap-removed, so every update is O(1) and a lookup hands
+// back the bucket itself instead of building a vector.
+//
+// Key IDs belong to the index and are reused once no placed actor carries
+// the key, so it only grows with the keys in use, however many unique
+// names come and go.
+//
+// Like the Workspace, it is meant to be used from the game thread.
+class TagIndex {
+public:
+  void Insert(int id, const std::string &key);
+  void Update(int id, const std::string &key); // Moves id to another key
+  void Remove(int id);
+  void Clear();
+
+  // IDs in no particular order, empty when no actor has the key. Inserting
+  // a new key may move every bucket, so code that places actors while it
+  // walks one looks it up again by key ID on each step, and stops once
+  // FindKey no longer returns that ID.
+  const std::vector<int> &Find(const std::string &key) const;
+  const std::vector<int> &Find(int keyID) const;
+  int FindKey(const std::string &key) const; // -1 when no placed actor has it
+  size_t GetKeyCount() const { return keyIDs.size(); }
+
+private:
+  struct Entry {
+    int key;
+    size_t position; // Index into buckets[key]
+  };
+
+  int AcquireKey(const std::string &key);
+  void ReleaseKey(int keyID); // Once its bucket is empty
+
+  std::vector<std::vector<int>> buckets; // Indexed by key ID
+  std::unordered_map<int, Entry> entries;
+  std::unordered_map<std::string, int> keyIDs;
+  std::vector<std::string> keys; // Key ID to key, for ReleaseKey
+  std::vector<int> freeKeys;
+};
+
+extern TagIndex WorkspaceTags;  // Placed actors by tag
+extern TagIndex WorkspaceNames; // Placed actors by name
+
+#endif
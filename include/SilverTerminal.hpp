@@ -0,0 +1,119 @@
+#ifndef SILVER_TERMINAL_HPP
+#define SILVER_TERMINAL_HPP
+
+#include "SilverFrameBuffer.hpp"
+#include "smath.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Where cameras and the console helpers send their output
+class TerminalSurface {
+public:
+  virtual ~TerminalSurface() = default;
+
+  // Cheap, surfaces keep their size instead of asking the backend each call
+  virtual Vector2 GetSize() = 0;
+  // Writes raw bytes (text and escape sequences), returns the write calls used
+  virtual int Write(const std::string &bytes) = 0;
+  virtual void Clear() = 0;
+  // Asks the backend for its size and tells the resize listeners if it
+  // changed. PollEvents does this once per frame for the global surface.
+  virtual void Refresh() {}
+
+  // listener gets the new size, on the thread that noticed the change
+  int AddResizeListener(std::function<void(Vector2)> listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listeners.emplace_back(++lastListenerID, std::move(listener));
+    return lastListenerID;
+  }
+  void RemoveResizeListener(int id) {
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                   [id](const auto &entry) { return entry.first == id; }),
+                    listeners.end());
+  }
+
+protected:
+  void NotifyResize(Vector2 size) {
+    std::vector<std::pair<int, std::function<void(Vector2)>>> called;
+    {
+      std::lock_guard<std::mutex> lock(listenerMutex);
+      called = listeners; // Listeners may add or remove listeners
+    }
+    for (auto &entry : called) entry.second(size);
+  }
+
+private:
+  std::mutex listenerMutex;
+  std::vector<std::pair<int, std::function<void(Vector2)>>> listeners;
+  int lastListenerID = 0;
+};
+
+// The console: the Windows console API on Windows, stdout and termios
+// elsewhere. Its size is read once when created and again on each Refresh,
+// every other GetSize is answered from the cache.
+class ConsoleSurface : public TerminalSurface {
+public:
+  ConsoleSurface();
+
+  Vector2 GetSize() override;
+  int Write(const std::string &bytes) override;
+  void Clear() override;
+  void Refresh() override;
+
+  size_t GetSizeQueries() const { return sizeQueries; } // Console API calls made by Refresh
+
+private:
+  void StoreSize(int width, int height); // Tells the resize listeners on a change
+
+  std::atomic<uint64_t> size{0}; // Width in the high half, height in the low one
+  std::atomic<size_t> sizeQueries{0};
+};
+
+// An in-memory terminal with a fixed size. It records every write and
+// keeps a decoded copy of the screen, so rendering can be benchmarked and
+// compared against golden frames without a console.
+class HeadlessSurface : public TerminalSurface {
+public:
+  HeadlessSurface(int width = 80, int height = 25);
+
+  void SetSize(int width, int height); // Tells the resize listeners
+  Vector2 GetSize() override;
+  int Write(const std::string &bytes) override;
+  void Clear() override;
+
+  // Raw bytes of every write, one entry per presented frame
+  std::vector<std::string> GetFrames();
+  void ClearFrames();
+  void SetCaptureFrames(bool value); // Turn off for long benchmarks
+
+  // Screen contents, one line per row, without styles
+  std::string GetScreenText();
+  Cell GetCell(int x, int y);
+
+private:
+  void Apply(const std::string &bytes);
+
+  std::mutex surfaceMutex;
+  FrameBuffer screen;
+  int cursorX = 0, cursorY = 0;
+  std::string activeAnsi;
+  uint16_t style = 0;
+  bool captureFrames = true;
+  std::vector<std::string> frames;
+};
+
+// Surface used by GetConsoleSize, Clear, Gotoxy and cameras without their
+// own target. Passing nullptr restores the console.
+void SetTerminalSurface(std::shared_ptr<TerminalSurface> surface);
+std::shared_ptr<TerminalSurface> GetTerminalSurface();
+
+#endif
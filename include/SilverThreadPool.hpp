@@ -0,0 +1,107 @@
+#ifndef SILVER_THREAD_POOL_HPP
+#define SILVER_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of std::thread workers, each with its own task deque. A worker
+// takes its newest task first and, when it runs dry, steals the oldest task
+// of another worker. Tasks queued from outside the pool are dealt out
+// round robin.
+//
+// Blocking inside a task holds a worker for the whole wait. Long-lived
+// behaviours should do a slice of work and Defer themselves instead, or run
+// on an SThread, which has a thread of its own.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned threadCount = 0); // 0 uses one less than the hardware threads
+  ~ThreadPool(); // Stops the workers, queued tasks are dropped
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned GetThreadCount() const { return static_cast<unsigned>(threads.size()); }
+
+  void Enqueue(std::function<void()> task);
+  // Queues task at low priority: deferred tasks run in order, and only when
+  // no worker has other work. For tasks that requeue themselves every slice
+  // and must not starve the others.
+  void Defer(std::function<void()> task);
+
+  // Runs func on the pool. The future also carries whatever func throws.
+  template <typename F> auto Submit(F &&func) -> std::future<decltype(func())> {
+    using Result = decltype(func());
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+    std::future<Result> future = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  // Calls body(chunkBegin, chunkEnd) over [begin, end) in chunks of grain
+  // and returns once every chunk ran. The calling thread takes chunks of
+  // this loop only, then blocks until the helpers finish theirs. It never
+  // waits on a helper that has not started, so this may be used from inside
+  // a task. The first exception is rethrown.
+  void ParallelFor(size_t begin, size_t end, size_t grain,
+                   const std::function<void(size_t, size_t)> &body);
+
+  // Runs one queued task on the calling thread, if there is one. Lets
+  // threads waiting on the pool help instead of idling.
+  bool RunPendingTask();
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Push(std::function<void()> task, bool isDeferred);
+  bool Pop(size_t self, std::function<void()> &task);
+  void WorkerLoop(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  Queue deferred; // Shared by all workers, see Defer
+  std::vector<std::thread> threads;
+  std::atomic<size_t> queuedTasks{0};
+  std::atomic<size_t> nextQueue{0};
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  bool stopping = false;
+};
+
+// Runs tasks on a pool and waits for all of them. Waiting helps run queued
+// tasks, so groups may be nested inside pool tasks.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool);
+  TaskGroup();  // Uses GetThreadPool()
+  ~TaskGroup(); // Waits
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  void Run(std::function<void()> task);
+  void Wait(); // Rethrows the first exception a task threw
+
+private:
+  struct State {
+    std::atomic<size_t> remaining{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+  };
+
+  ThreadPool &pool;
+  std::shared_ptr<State> state = std::make_shared<State>();
+};
+
+// Engine-wide pool. Never destroyed, so detached work may outlive main.
+ThreadPool &GetThreadPool();
+
+#endif
@@ -1,36 +1,47 @@
 #ifndef SILVER_THREADING_HPP
 #define SILVER_THREADING_HPP
 
-#include <windows.h>
-#include <queue>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
 
+// Serial task queue with a thread of its own. Tasks run one at a time, in
+// the order they were enqueued. Unlike pool tasks they may block for as
+// long as they like, since nothing else waits on that thread.
 class SThread {
 public:
     SThread();
-    ~SThread();
+    ~SThread(); // Stops unless detached
 
     void Enqueue(std::function<void()> task);
     void StartThread();
-    void StopThread();
-    void PauseThread();
+    void StopThread();   // Waits for the running task, the rest stay queued
+    void PauseThread();  // Takes effect after the running task
     void ResumeThread();
-    void JoinThread();
-    void DetachThread();
+    void JoinThread();   // Waits until the queue is drained, paused or stopped
+    void DetachThread(); // Queued tasks keep running after destruction
 
 private:
-    void ThreadFunction();
-    static DWORD WINAPI ThreadWrapper(LPVOID lpParam);
+    struct State {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::queue<std::function<void()>> taskQueue;
+        bool isRunning = false;
+        bool isPaused = false;
+        bool isBusy = false;       // A task is running
+        bool isOrphaned = false;   // Detached and destroyed, exit once drained
+    };
+
+    static void ThreadFunction(std::shared_ptr<State> state);
+    bool IsOwnThread() const { return thread.get_id() == std::this_thread::get_id(); }
 
-    HANDLE hThread;
-    HANDLE hQueueEvent;  // Signals when tasks are available
-    HANDLE hPauseEvent;  // Signals when thread should pause/resume
-    HANDLE hStopEvent;   // Signals when thread should stop
-    CRITICAL_SECTION queueCS;
-    
-    std::queue<std::function<void()>> taskQueue;
-    bool isPaused;
-    bool isRunning;
+    std::shared_ptr<State> state;
+    std::thread thread;
+    bool isDetached = false;
 };
 
-#endif // SILVER_THREADING_HPP
\ No newline at end of file
+#endif // SILVER_THREADING_HPP
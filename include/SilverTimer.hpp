@@ -12,17 +12,19 @@ public:
     void Resume();
     void Stop();
     void Reset();
-    long long GetElapsedTime() const;
+    long long GetElapsedTime() const;        // Milliseconds
+    long long GetElapsedNanoseconds() const;
+
+    // Monotonic clock reading, for measuring without a Timer
+    static long long NowNanoseconds();
 
 private:
     bool isRunning;
     bool isPaused;
-    std::chrono::high_resolution_clock::time_point startTime;
-    std::chrono::high_resolution_clock::time_point stopTime;
-    std::chrono::high_resolution_clock::time_point pauseTime;
-    std::chrono::high_resolution_clock::time_point resumeTime;
-    long long accumulatedPausedTime;
-    long long totalDuration;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point pauseTime;
+    long long accumulatedPausedTime; // Nanoseconds
+    long long totalDuration;         // Nanoseconds
 };
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef SILVER_TIMER_WHEEL_HPP
+#define SILVER_TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Refers to a scheduled timer. The generation tells a handle to a finished
+// timer apart from the one that reused its slot.
+struct TimerHandle {
+  int slot = -1;
+  unsigned generation = 0;
+
+  bool IsValid() const { return slot >= 0; }
+};
+
+// Hierarchical timing wheel: four levels of 256 slots, each level 256
+// times coarser than the one below. A timer sits in the slot its due tick
+// falls in on the lowest level it fits, and moves down as time reaches that
+// slot. Scheduling and cancelling are O(1); advancing costs the ticks
+// passed over plus the timers fired or moved, with empty stretches skipped.
+//
+// Delays are measured from the wheel's current time, the last Advance.
+// Callbacks run on the thread advancing the wheel and may schedule and
+// cancel timers. Not thread safe.
+class TimerWheel {
+public:
+  explicit TimerWheel(double resolution = 0.0001); // Tick length in seconds
+
+  TimerHandle Schedule(double delay, std::function<void()> callback);
+  // Fires every interval, the first time after firstDelay (interval if
+  // negative). Periods missed by a long advance are skipped, not replayed.
+  TimerHandle ScheduleRepeating(double interval, std::function<void()> callback,
+                                double firstDelay = -1);
+  bool Cancel(TimerHandle handle); // False if it already fired or was cancelled
+  bool IsPending(TimerHandle handle) const;
+  void Clear();
+
+  size_t Size() const { return pending; }
+  double GetTime() const; // Seconds since the wheel was made
+
+  // Each fires the timers that came due, in due order, and returns how
+  // many fired
+  size_t AdvanceBy(double seconds);
+  size_t Advance(); // By the real time since the previous Advance
+
+private:
+  static const int levelBits = 8;
+  static const int levels = 4;
+  static const int slotsPerLevel = 1 << levelBits;
+  static const int dueList = levels * slotsPerLevel; // Overdue, fire on the next advance
+  static const int firingList = dueList + 1;
+  static const int listCount = firingList + 1;
+
+  struct Node {
+    std::function<void()> callback;
+    uint64_t due = 0;      // Tick
+    uint64_t interval = 0; // Ticks, 0 for one-shot
+    int prev = -1, next = -1;
+    int list = -1;         // -1 when free
+    unsigned generation = 0;
+  };
+
+  TimerHandle Add(uint64_t due, uint64_t interval, std::function<void()> callback);
+  void Place(int index);
+  void Link(int index, int list);
+  void Unlink(int index);
+  void Release(int index);
+  void Cascade(int level);
+  size_t FireList(int list);
+  int NextOccupied(int level, int from) const; // First occupied slot >= from, or -1
+  uint64_t ToTicks(double seconds) const;
+
+  double resolution;
+  uint64_t currentTick = 0;
+  long long lastClock = -1; // Nanoseconds, for Advance()
+  std::vector<Node> nodes;
+  std::vector<int> freeNodes;
+  std::vector<int> heads = std::vector<int>(listCount, -1);
+  uint64_t occupied[levels][slotsPerLevel / 64] = {}; // Non-empty slots
+  size_t pending = 0;
+};
+
+extern TimerWheel WorkspaceTimers; // Advanced by WorkspaceScheduler
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef SILVER_TRANSFORM_POOL_HPP
+#define SILVER_TRANSFORM_POOL_HPP
+
+#include "smath.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Transform;
+
+// Refers to a row of the transform pool. The generation tells a handle to a
+// removed row apart from the one that reused its slot.
+struct TransformHandle {
+  int slot = -1;
+  unsigned generation = 0;
+
+  bool IsValid() const { return slot >= 0; }
+};
+
+// Optional dense storage for transforms. Positions, rotations, scales,
+// velocities and tags live in parallel arrays, so batch updates are tight
+// loops over contiguous memory. A dense Transform keeps nothing itself: its
+// getters and setters read and write its row, so batch updates need no
+// copying either way and only queue the moved actors for the spatial index.
+//
+// Not thread safe, use it from the game thread.
+class TransformPool {
+public:
+  TransformHandle Add(Transform *owner);
+  void Remove(TransformHandle handle);
+  bool Contains(TransformHandle handle) const;
+  size_t Size() const { return owners.size(); }
+
+  // Invalid handles read as the identity transform and ignore writes
+  Vector3 GetPosition(TransformHandle handle) const;
+  void SetPosition(TransformHandle handle, Vector3 position);
+  double GetRotation(TransformHandle handle) const;
+  void SetRotation(TransformHandle handle, double rotation);
+  Vector3 GetScale(TransformHandle handle) const;
+  void SetScale(TransformHandle handle, Vector3 scale);
+  Vector3 GetVelocity(TransformHandle handle) const;
+  void SetVelocity(TransformHandle handle, Vector3 velocity);
+  int GetTag(TransformHandle handle) const;
+  void SetTag(TransformHandle handle, int tag);
+
+  // Batch updates
+  void TranslateAll(Vector3 offset);
+  void TranslateTagged(int tag, Vector3 offset);
+  void AdvanceVelocities(double deltaTime); // position += velocity * deltaTime
+
+private:
+  int DenseIndex(TransformHandle handle) const;
+  void Publish(); // Marks the actors of changed rows dirty in the spatial index
+
+  // Rows, all the same length
+  std::vector<double> positionX, positionY, positionZ;
+  std::vector<double> rotation;
+  std::vector<double> scaleX, scaleY, scaleZ;
+  std::vector<double> velocityX, velocityY, velocityZ;
+  std::vector<int> tags;
+  std::vector<uint8_t> changed;
+  std::vector<Transform *> owners;
+  std::vector<int> rowSlots; // Row to slot
+
+  // Slots give handles a stable target while rows are swap-removed
+  std::vector<int> slotRows; // Slot to row, -1 when free
+  std::vector<unsigned> slotGenerations;
+  std::vector<int> freeSlots;
+  std::vector<int> movedIDs; // Scratch list for the spatial index
+};
+
+// Never destroyed, so transforms released during static destruction can
+// still unregister themselves
+TransformPool &GetTransformPool();
+
+#endif
@@ -1,13 +1,18 @@
 #ifndef SILVER_VMOUSE_HPP
 #define SILVER_VMOUSE_HPP
 
+#include "SilverInput.hpp"
+
 #include <string>
-#include <windows.h>
 
 void StopVMouse();
 void StartVMouse(int leftKey, int rightKey, int upKey, int downKey, int clickKey);
 bool WasMouseClicked();
 
+// Moves the cursor one cell per held direction key. PollEvents calls it
+// with each live frame, so the cursor moves in step with the game loop.
+void StepVMouse(const KeySet &keys);
+
 extern int mouseKey;
 extern int cursorPositionX;
 extern int cursorPositionY;
@@ -14,17 +14,19 @@
 #include <iostream>
 #include <limits.h>
 #include <map>
+#include <mutex>
 #include <random>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <typeindex>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
+#include <thread>
 #include <vector>
-#include <windows.h>
 
 using namespace std;
 
@@ -38,17 +40,102 @@ const World emptyWorld;
 std::map<std::string, Actor> Prefabs;
 
 bool debugMode = true;
+std::atomic<unsigned> consoleClearCount{0};
 bool isFirstCameraOutput = true;
 Rect StageArea = Rect(-50, -50, 100, 100);
 
-int nextObjectID = 0;
+// Instance IDs keep a slot index in the low bits and the slot's generation
+// above it. Removing an actor bumps the generation, so old IDs go stale.
+static const int actorIndexBits = 20;
+static const int actorIndexMask = (1 << actorIndexBits) - 1;
+static const int actorGenerationMask = (1 << (31 - actorIndexBits)) - 1;
+
+struct ActorSlot {
+  std::weak_ptr<Actor> actor;
+  int generation = 0;
+  bool used = false;
+};
+
+struct ActorSlotTable {
+  std::mutex mutex;
+  std::vector<ActorSlot> slots;
+  std::vector<int> freeSlots;
+};
+
+// Never destroyed, so actors released during static destruction can still
+// hand back their slot
+static ActorSlotTable &GetActorSlots() {
+  static ActorSlotTable *table = new ActorSlotTable();
+  return *table;
+}
+
+static int AcquireActorID(const std::shared_ptr<Actor> &actor) {
+  ActorSlotTable &table = GetActorSlots();
+  std::lock_guard<std::mutex> lock(table.mutex);
+
+  int index;
+  if (!table.freeSlots.empty()) {
+    index = table.freeSlots.back();
+    table.freeSlots.pop_back();
+  } else {
+    if (table.slots.size() > static_cast<size_t>(actorIndexMask)) {
+      std::cerr << "Error: Too many actors in the Workspace." << std::endl;
+      return -1;
+    }
+    index = static_cast<int>(table.slots.size());
+    table.slots.emplace_back();
+  }
+
+  ActorSlot &slot = table.slots[index];
+  slot.actor = actor;
+  slot.used = true;
+  return (slot.generation << actorIndexBits) | index;
+}
+
+// Returns the slot of a live ID, or nullptr. Call with the table locked.
+static ActorSlot *FindActorSlot(ActorSlotTable &table, int id) {
+  if (id < 0) return nullptr;
+  size_t index = id & actorIndexMask;
+  if (index >= table.slots.size()) return nullptr;
+
+  ActorSlot &slot = table.slots[index];
+  if (!slot.used || slot.generation != (id >> actorIndexBits)) return nullptr;
+  return &slot;
+}
+
+// Only when the actor is already gone if onlyIfDestroyed is set
+static void ReleaseActorID(int id, bool onlyIfDestroyed) {
+  ActorSlotTable &table = GetActorSlots();
+  std::lock_guard<std::mutex> lock(table.mutex);
+
+  ActorSlot *slot = FindActorSlot(table, id);
+  if (slot == nullptr) return;
+  if (onlyIfDestroyed && !slot->actor.expired()) return;
+
+  slot->actor.reset();
+  slot->used = false;
+  slot->generation = (slot->generation + 1) & actorGenerationMask;
+  table.freeSlots.push_back(id & actorIndexMask);
+}
 
 Actor::Actor(const Actor& other)
-    : name(other.name), objectID(nextObjectID++), intValues(other.intValues),
-      stringValues(other.stringValues), tag(other.tag) {
+    : intValues(other.intValues), stringValues(other.stringValues),
+      name(other.name), tag(other.tag) {
 
+    objectComponents.reserve(other.objectComponents.size());
     for (const auto& component : other.objectComponents) {
         objectComponents.push_back(component->Clone());
+        objectComponents.back()->UnsafeSetParent(this);
+    }
+
+    // Same types in the same order, so the slots map across directly
+    componentSlots.assign(other.componentSlots.size(), nullptr);
+    for (size_t slot = 0; slot < other.componentSlots.size(); slot++) {
+        for (size_t i = 0; i < other.objectComponents.size(); i++) {
+            if (other.objectComponents[i].get() == other.componentSlots[slot]) {
+                componentSlots[slot] = objectComponents[i].get();
+            }
+        }
     }
    
     for (const auto& child : other.children) {
@@ -59,9 +146,79 @@ Actor::Actor(const Actor& other)
 }
 
 
+size_t ComponentTypeID(const std::type_index &type) {
+  static std::mutex registryMutex;
+  static std::unordered_map<std::type_index, size_t> registry;
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+  auto it = registry.find(type);
+  if (it != registry.end()) return it->second;
+
+  size_t id = registry.size();
+  registry.emplace(type, id);
+  return id;
+}
+
+void Actor::AttachComponent(std::shared_ptr<Component> component, size_t typeID) {
+  component->UnsafeSetParent(this);
+  objectComponents.push_back(component);
+
+  if (typeID >= componentSlots.size()) componentSlots.resize(typeID + 1, nullptr);
+  componentSlots[typeID] = component.get();
+  WorkspaceIndex.MarkDirty(objectID);
+}
+
+bool Actor::DetachComponent(Component *component) {
+  if (component == nullptr) return false;
+
+  auto it = std::find_if(objectComponents.begin(), objectComponents.end(),
+                         [component](const std::shared_ptr<Component> &entry) {
+                           return entry.get() == component;
+                         });
+  if (it == objectComponents.end()) return false;
+
+  for (auto &slot : componentSlots) {
+    if (slot == component) slot = nullptr;
+  }
+  objectComponents.erase(it);
+  WorkspaceIndex.MarkDirty(objectID);
+  return true;
+}
+
+// Frees the slot of an actor dropped without RemoveObject, for example by
+// clearing the Workspace
+Actor::~Actor() {
+  if (objectID >= 0) ReleaseActorID(objectID, true);
+}
+
+// True for the actor stored in the Workspace under its ID. A prefab
+// reports the ID of the copy AddObject placed, so that alone is not enough.
+static bool IsPlacedActor(const Actor *actor, int id) {
+  auto it = Workspace.find(id);
+  return it != Workspace.end() && it->second.get() == actor;
+}
+
+void Actor::SetTag(const std::string &value) {
+  tag = value;
+  if (IsPlacedActor(this, objectID)) WorkspaceTags.Update(objectID, tag);
+
+  Transform *transform = GetComponent<Transform>();
+  if (transform && transform->IsDense()) {
+    GetTransformPool().SetTag(transform->GetHandle(), InternTag(tag));
+  }
+}
+
+void Actor::SetName(const std::string &value) {
+  name = value;
+  if (IsPlacedActor(this, objectID)) WorkspaceNames.Update(objectID, name);
+}
+
 std::shared_ptr<Actor> InstanceIDToActor(int objID) {
-  if(Workspace.find(objID) != Workspace.end()) return Workspace[objID];
-  return nullptr;
+  ActorSlotTable &table = GetActorSlots();
+  std::lock_guard<std::mutex> lock(table.mutex);
+
+  ActorSlot *slot = FindActorSlot(table, objID);
+  return slot ? slot->actor.lock() : nullptr;
 }
 
 
@@ -101,18 +258,28 @@ void Destroy(std::shared_ptr<Actor> actor) {
   actor->RemoveObject();
 }
 
+void Destroy(int objID) {
+  auto it = Workspace.find(objID);
+  if (it != Workspace.end()) it->second->RemoveObject();
+}
+
 void SetConsoleTitle(const string title) {
   cout << "\033]0;" << title << "\007";
 }
 
-void Clear() { system("cls"); }
+void Clear() {
+  GetTerminalSurface()->Clear();
+  consoleClearCount++;
+}
 
 bool Gotoxy(int x, int y) {
-  int consoleWidth = GetConsoleSize().x, consoleHeight = GetConsoleSize().y;
+  Vector2 consoleSize = GetConsoleSize();
+  int consoleWidth = consoleSize.x, consoleHeight = consoleSize.y;
   if (x < 0 || x >= consoleWidth || y < 0 || y >= consoleHeight) {
     return false; // Do nothing if the coordinates are out of bounds
   }
-  cout << "\033[" << y + 1 << ";" << x + 1 << "H" << flush;
+  cout << flush;
+  GetTerminalSurface()->Write("\033[" + to_string(y + 1) + ";" + to_string(x + 1) + "H");
   return true;
 }
 
@@ -448,13 +615,11 @@ void loadChunk(const string file) {
 */
 
 Vector2 GetConsoleSize() {
-  CONSOLE_SCREEN_BUFFER_INFO csbi;
-  if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) {
-      return Vector2(80, 25);  // Default fallback size
-  }
-  int width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
-  int height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
-  return Vector2(width, height);
+  return GetTerminalSurface()->GetSize();
+}
+
+void RefreshConsoleSize() {
+  GetTerminalSurface()->Refresh();
 }
 
 Vector2 GetConsoleCenter() {
@@ -462,77 +627,176 @@ Vector2 GetConsoleCenter() {
   return Vector2(size.x / 2, size.y / 2);
 }
 
-void Transform::Translate(Vector3 offset) { position += offset; }
+void Transform::Translate(Vector3 offset) {
+  SetPosition(GetPosition() + offset);
+}
 
-void Actor::AddObject() {
-    // Add the current object to the Workspace
-    objectID = nextObjectID;
-    Workspace[nextObjectID] = std::make_shared<Actor>(*this); // Deep copy
-    nextObjectID++;
+void Transform::SetPosition(Vector3 value) {
+  if (handle.IsValid()) {
+    GetTransformPool().SetPosition(handle, value);
+  } else {
+    position = value;
+  }
+  MarkMoved();
+}
 
-    return;
+void Transform::SetRotation(double value) {
+  if (handle.IsValid()) {
+    GetTransformPool().SetRotation(handle, value);
+  } else {
+    rotation = value;
+  }
+  MarkMoved();
 }
 
-void Actor::PlaceObject() {
-    // Create a new actor by copying the current one (deep copy)
-    auto actorCopy = std::make_shared<Actor>(*this);
+void Transform::SetScale(Vector3 value) {
+  if (handle.IsValid()) {
+    GetTransformPool().SetScale(handle, value);
+  } else {
+    scale = value;
+  }
+  MarkMoved();
+}
 
-    // Set the object ID for the new actor
-    actorCopy->objectID = nextObjectID;
+void Transform::MarkMoved() {
+  if (parent) WorkspaceIndex.MarkDirty(parent->GetInstanceID());
+}
 
-    // Add the new actor to the Workspace
-    Workspace[nextObjectID] = actorCopy;
+Transform::Transform(const Transform &other)
+    : Component(other), position(other.GetPosition()), rotation(other.GetRotation()),
+      scale(other.GetScale()) {
+  if (other.IsDense()) {
+    TransformPool &pool = GetTransformPool();
+    handle = pool.Add(this);
+    pool.SetVelocity(handle, pool.GetVelocity(other.handle));
+    pool.SetTag(handle, pool.GetTag(other.handle));
+  }
+}
 
-    // Increment the nextObjectID for the next object
-    nextObjectID++;
+Transform &Transform::operator=(const Transform &other) {
+  if (this != &other) {
+    Component::operator=(other);
+    Vector3 newPosition = other.GetPosition(), newScale = other.GetScale();
+    double newRotation = other.GetRotation();
+    if (handle.IsValid()) {
+      TransformPool &pool = GetTransformPool();
+      pool.SetPosition(handle, newPosition);
+      pool.SetRotation(handle, newRotation);
+      pool.SetScale(handle, newScale);
+    } else {
+      position = newPosition;
+      rotation = newRotation;
+      scale = newScale;
+    }
+  }
+  return *this;
+}
 
-    return;
+Transform::~Transform() {
+  if (handle.IsValid()) GetTransformPool().Remove(handle);
 }
 
-void Actor::PlaceObjectAt(Vector3 location) {
-    // Create a new actor by copying the current one
-    auto actorCopy = std::make_shared<Actor>(*this);
+void Transform::SetDense(bool value) {
+  if (value == IsDense()) return;
+  if (value) {
+    handle = GetTransformPool().Add(this);
+  } else {
+    // Back into the fields before the row goes
+    position = GetPosition();
+    rotation = GetRotation();
+    scale = GetScale();
+    GetTransformPool().Remove(handle);
+    handle = TransformHandle();
+  }
+}
 
-    // Ensure components are cloned properly
-    actorCopy->objectComponents.clear();  // Remove shallow copies
+// Deep copy carved from the actor pool
+std::shared_ptr<Actor> Actor::MakeInstance() const {
+    return std::allocate_shared<Actor>(PoolAllocator<Actor>(), *this);
+}
 
-    for (const auto& comp : objectComponents) {
-        auto clonedComponent = comp->Clone();
-        clonedComponent->UnsafeSetParent(actorCopy.get());
-        actorCopy->objectComponents.push_back(clonedComponent);
-    }
+int Actor::Place(const std::shared_ptr<Actor> &instance) {
+    int id = AcquireActorID(instance);
+    if (id < 0) return -1;
+
+    instance->objectID = id;
+    Workspace[id] = instance;
+    WorkspaceIndex.Insert(id);
+    WorkspaceTags.Insert(id, instance->GetTag());
+    WorkspaceNames.Insert(id, instance->GetName());
+    return id;
+}
+
+void Actor::AddObject() {
+    // Add the current object to the Workspace, this actor reports the copy's ID
+    objectID = Place(MakeInstance());
+}
+
+void Actor::PlaceObject() {
+    Place(MakeInstance());
+}
+
+void Actor::PlaceObjectAt(Vector3 location) {
+    // Create a new actor by copying the current one
+    auto actorCopy = MakeInstance();
 
     // Update the new actor's transform position
     auto transform = actorCopy->GetComponent<Transform>();
     if (transform) {
-        transform->position = location;
+        transform->SetPosition(location);
     }
 
-    // Assign a new unique object ID
-    actorCopy->objectID = nextObjectID++;
-
-    // Store the duplicate in the workspace
-    Workspace[actorCopy->objectID] = actorCopy;
+    Place(actorCopy);
 }
 
 
 void Actor::RemoveObject() {
-  std::shared_ptr<Actor> target = shared_from_this();
-  
-  // Find the object ID to remove
-  int id = objectID;
-
-  // Remove the object from the Workspace
-  auto it = std::find_if(Workspace.begin(), Workspace.end(),
-    [&target](const std::pair<const int, std::shared_ptr<Actor>>& p) {
-        return p.second == target;  // Compare the std::shared_ptr<Actor> part of the pair
-    });
+  if (!IsPlacedActor(this, objectID)) return;
+
+  std::shared_ptr<Actor> target = Workspace[objectID]; // Keeps this alive until we return
+  ReleaseActorID(objectID, false);
+  WorkspaceIndex.Remove(objectID);
+  WorkspaceTags.Remove(objectID);
+  WorkspaceNames.Remove(objectID);
+  Workspace.erase(objectID);
+}
 
-  if (it != Workspace.end()) {
-    Workspace.erase(it);  // Erase the target object from the Workspace
+// Removes every listed ID in one pass, returns how many were placed
+static int RemoveObjects(const std::vector<int> &ids) {
+  WorkspaceIndex.Remove(ids);
+
+  int removed = 0;
+  for (int id : ids) {
+    auto it = Workspace.find(id);
+    if (it == Workspace.end()) continue;
+    ReleaseActorID(id, false);
+    WorkspaceTags.Remove(id);
+    WorkspaceNames.Remove(id);
+    Workspace.erase(it);
+    removed++;
   }
+  return removed;
+}
 
-  return;
+int DestroyObjectsWithTag(const std::string tag) {
+  std::vector<int> ids = WorkspaceTags.Find(tag); // Copied, removal edits the bucket
+  return RemoveObjects(ids);
+}
+
+int DestroyObjectsInRect(const Rect &area) {
+  std::vector<int> candidates, ids;
+  WorkspaceIndex.Query(area, candidates);
+
+  for (int id : candidates) {
+    auto it = Workspace.find(id);
+    if (it == Workspace.end() || it->second->GetComponent<UI>() != nullptr) continue;
+
+    Transform *transform = it->second->GetComponent<Transform>();
+    if (transform && area.Contains(Vector2(transform->GetPosition().x, transform->GetPosition().y))) {
+      ids.push_back(id);
+    }
+  }
+  return RemoveObjects(ids);
 }
 
 
@@ -542,7 +806,7 @@ void Hold() {
 }
 
 void Wait(int time) {
-  Sleep(time);
+  this_thread::sleep_for(chrono::milliseconds(time));
 }
 
 int GetRandom(int min, int max) {
@@ -552,34 +816,6 @@ int GetRandom(int min, int max) {
   return dist(rng);
 }
 
-void setRawMode(bool value) {
-  HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
-  DWORD mode;
-  GetConsoleMode(hInput, &mode);
-
-  if (value) {
-      mode &= ~(ENABLE_ECHO_INPUT | ENABLE_LINE_INPUT);
-  } else {
-      mode |= (ENABLE_ECHO_INPUT | ENABLE_LINE_INPUT);
-  }
-
-  SetConsoleMode(hInput, mode);
-}
-
-void setNonBlockingMode(bool value) {
-  HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
-  DWORD mode;
-  GetConsoleMode(hInput, &mode);
-
-  if (value) {
-      mode &= ~ENABLE_LINE_INPUT;  // Disable line buffering
-  } else {
-      mode |= ENABLE_LINE_INPUT;   // Restore line buffering
-  }
-
-  SetConsoleMode(hInput, mode);
-}
-
 vector<Vector3> getOvalPoints(Vector3 center, Vector3 scale) {
   vector<Vector3> points;
   for (int y = center.y - scale.y; y <= center.y + scale.y; ++y) {
@@ -681,11 +917,38 @@ vector<Vector3> getRectangleHollowPoints(Vector3 topLeft, int width, int height)
 
 bool IsAlive(int obj) { return InstanceIDToActor(obj) != nullptr; }
 
+// State of one ApplyFunction call
+struct ApplyDispatch {
+  std::vector<int> ids;
+  std::function<void(int)> func;
+  char mode;
+  Vector3 pos;
+  std::atomic<int> subscription{-1};
+};
+
+// Runs on the pool, never twice at once for the same call
+static void RunApplyDispatch(ApplyDispatch &dispatch, const InputEvent &event) {
+  if ((dispatch.mode == 'c' || dispatch.mode == 'C' || dispatch.mode == 'h' || dispatch.mode == 'H') &&
+      !(Vector3(event.cursorX, event.cursorY, 0) == dispatch.pos)) {
+    return;
+  }
+
+  std::vector<int> &ids = dispatch.ids;
+  ids.erase(std::remove_if(ids.begin(), ids.end(), [](int obj) { return !IsAlive(obj); }),
+            ids.end());
+  if (ids.empty()) {
+    InputEvents.Unsubscribe(dispatch.subscription);
+    return;
+  }
+
+  for (int obj : ids) {
+    if (IsAlive(obj)) dispatch.func(obj); // func may destroy the others
+  }
+}
+
 void ApplyFunction(const std::vector<int> &ids, std::function<void(int)> func,
                    char mode, ...) {
-  std::vector<int> targetObjects;
   int key = 0;
-  Vector3 pos = {0, 0, 0};
   va_list args;
   va_start(args, mode);
 
@@ -696,66 +959,69 @@ void ApplyFunction(const std::vector<int> &ids, std::function<void(int)> func,
   }
   va_end(args);
 
-  for (int obj : ids) {
-    // Capture variables for the lambda
-    auto task = [obj, func, mode, key, pos]() mutable {
-      while (IsAlive(obj)) {
-        if (mode == 'k' || mode == 'm' || mode == 'c' || mode == 'C') {
-          while (true) {
-            if (IsKey(key)) {
-              if (mode == 'c' || mode == 'C') {
-                Vector3 cursorPosition =
-                    (cursorPositionX, cursorPositionY, 0);
-                if (cursorPosition == pos) {
-                  break;
-                }
-              } else {
-                break;
-              }
-            }
-          }
-        }
-
-        if (mode == 'h' || mode == 'H') {
-          while (true) {
-            Vector3 cursorPosition = Vector3(cursorPositionX, cursorPositionY, 0);
-            if (cursorPosition == pos) {
-              break;
-            }
-          }
-        }
-
-        func(obj); // Execute the provided function
-      }
-    };
-
-    // Create and manage the thread using ThreadManager
-    SThread functionThread;
-    functionThread.Enqueue(task);
-    functionThread.StartThread();
-    functionThread.DetachThread();
-  }
+  auto dispatch = std::make_shared<ApplyDispatch>();
+  dispatch->ids = ids;
+  dispatch->func = func;
+  dispatch->mode = mode;
+  dispatch->pos = Vector3(0, 0, 0);
+
+  // Key modes wait for their key, the rest run once per poll
+  bool keyMode = mode == 'k' || mode == 'm' || mode == 'c' || mode == 'C';
+  dispatch->subscription = InputEvents.Subscribe(
+      keyMode ? InputEventType::KeyHeld : InputEventType::Frame, keyMode ? key : -1,
+      [dispatch](const InputEvent &event) { RunApplyDispatch(*dispatch, event); }, true);
 }
 
 
 
 vector<std::shared_ptr<Actor>> FindObjectsWithTag(const string tag) {
   vector<std::shared_ptr<Actor>> actors;
-  for (auto it = Workspace.begin(); it != Workspace.end(); ++it) {
-    auto& key = it->first;
-    auto& entry = it->second;
-    if(entry->tag == tag) actors.push_back(entry);
-  }
-
+  ForEachObjectWithTag(tag, [&actors](const std::shared_ptr<Actor> &actor) {
+    actors.push_back(actor);
+  });
   return actors;
 }
 
+// Actors erased from Workspace without RemoveObject leave stale ids behind,
+// which InstanceIDToActor no longer resolves
+static std::shared_ptr<Actor> FirstInBucket(const std::vector<int> &ids) {
+  for (size_t i = ids.size(); i-- > 0;) {
+    std::shared_ptr<Actor> actor = InstanceIDToActor(ids[i]);
+    if (actor) return actor;
+  }
+  return nullptr;
+}
+
 std::shared_ptr<Actor> FindObjectWithTag(const string tag) {
-  for (auto it = Workspace.begin(); it != Workspace.end(); ++it) {
-    auto& key = it->first;
-    auto& entry = it->second;
-    if(entry->tag == tag) return entry;
+  return FirstInBucket(WorkspaceTags.Find(tag));
+}
+
+std::shared_ptr<Actor> FindObjectWithName(const string name) {
+  return FirstInBucket(WorkspaceNames.Find(name));
+}
+
+// Walks backwards so removing the visited actor, which swaps the last
+// entry into its place, does not skip anything. The bucket is looked up on
+// every step because placing an actor with a new key can move it, and the
+// walk ends if the last actor with the key went and its ID was reused.
+static void ForEachInBucket(const TagIndex &index, const std::string &key,
+                            const std::function<void(const std::shared_ptr<Actor> &)> &func) {
+  int keyID = index.FindKey(key);
+  if (keyID < 0) return;
+
+  for (size_t i = index.Find(keyID).size(); i-- > 0;) {
+    if (index.FindKey(key) != keyID) return;
+    const std::vector<int> &ids = index.Find(keyID);
+    if (i >= ids.size()) continue;
+    std::shared_ptr<Actor> actor = InstanceIDToActor(ids[i]);
+    if (actor) func(actor);
   }
+}
 
-  return nullptr;
+void ForEachObjectWithTag(const std::string &tag, const std::function<void(const std::shared_ptr<Actor> &)> &func) {
+  ForEachInBucket(WorkspaceTags, tag, func);
+}
+
+void ForEachObjectWithName(const std::string &name, const std::function<void(const std::shared_ptr<Actor> &)> &func) {
+  ForEachInBucket(WorkspaceNames, name, func);
 }
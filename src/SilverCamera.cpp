@@ -1,27 +1,42 @@
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <csignal>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <mutex>
 #include <regex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <vector>
 
-#include <windows.h>
-
 
 #include "Silver.hpp"
 
 // Member variables
+// Only the game thread changes activeCameras, and only with camerasMutex
+// held. The video thread holds it for a whole pass, so a camera is never
+// drawn after StopVideo or its destructor has returned.
 std::vector<Camera *> activeCameras;
+std::mutex camerasMutex;
 std::atomic<bool> isRunning{false};
-std::vector<std::vector<std::string>> renderBuffer;
-HANDLE videoThread;
+// Stops and joins the video thread when the program ends, since a joinable
+// std::thread left to its destructor ends the process
+struct VideoThread {
+  std::thread thread;
+  ~VideoThread() {
+    isRunning = false;
+    if (thread.joinable()) thread.join();
+  }
+} videoThread;
 
 double FPS = 10;
 
@@ -71,151 +86,231 @@ GetActiveCameras() {
   return activeCameras;
 }
 
-int previousConsoleWidth = 0;
-int previousConsoleHeight = 0;
+std::shared_ptr<TerminalSurface> Camera::GetSurface() {
+  std::shared_ptr<TerminalSurface> target = std::atomic_load(&surface);
+  return target ? target : GetTerminalSurface();
+}
 
-void Camera::RenderFrame() {
-  auto consoleSize = GetConsoleSize();
-  int consoleWidth = consoleSize.x;
-  int consoleHeight = consoleSize.y;
-  
-  Vector3 cameraScale = scale;
-  Vector3 cameraDisplayPosition = displayPosition;
-  
-  if(useRelativeTransform) {
-    cameraScale.x = consoleWidth * cameraRect.width;
-    cameraScale.y = consoleHeight * cameraRect.height;
-    cameraDisplayPosition.x = (consoleWidth + 1) * cameraRect.x;
-    cameraDisplayPosition.y = (consoleHeight + 1) * cameraRect.y;
+void Camera::SetSurface(std::shared_ptr<TerminalSurface> target) {
+  std::atomic_store(&surface, std::move(target));
+  InvalidateFrame();
+}
+
+// Blanks a screen rectangle with one write, clipped to the surface
+static void EraseRegion(TerminalSurface &target, int left, int top, int width, int height) {
+  Vector2 size = target.GetSize();
+  int right = std::min(left + width, static_cast<int>(size.x));
+  left = std::max(0, left);
+  if (right <= left) return;
+
+  std::string erase;
+  for (int y = std::max(0, top); y < top + height && y < size.y; y++) {
+    erase += "\033[" + std::to_string(y + 1) + ";" + std::to_string(left + 1) + "H";
+    erase.append(right - left, ' ');
   }
+  if (!erase.empty()) target.Write(erase);
+}
 
-  vector<std::string> leftTextLines, rightTextLines;
-  int leftTextLinesCount = 0, rightTextLinesCount = 0;
+// Splits text on '\n' and decodes each line
+static void SplitLines(const std::string &text, std::vector<TextLine> &lines) {
+  lines.clear();
+  if (text.empty()) return;
+  stringstream ss(text);
+  std::string line;
+  while (getline(ss, line)) {
+    lines.emplace_back();
+    lines.back().cells = DecodeText(line);
+  }
+}
 
-  if (!Camera::rightText.empty()) {
-    stringstream ss(Camera::rightText);
-    std::string line;
-    while (getline(ss, line)) {
-      rightTextLines.push_back(line);
-      rightTextLinesCount++;
-    }
+static int MaxWidth(const std::vector<TextLine> &lines) {
+  int width = 0;
+  for (const TextLine &line : lines) width = std::max(width, static_cast<int>(line.cells.size()));
+  return width;
+}
+
+// See SetParallelRenderCells. Read by the video thread.
+static std::atomic<int> minParallelCells{4096};
+static const int minBandRows = 4;
+
+void SetParallelRenderCells(int cells) { minParallelCells = std::max(0, cells); }
+int GetParallelRenderCells() { return minParallelCells; }
+
+void Camera::RenderFrame() {
+  if (isRunningCam) {
+    PublishSnapshot(); // The video thread owns the frame state
+    return;
   }
-  if (!Camera::leftText.empty()) {
-    stringstream ss(Camera::leftText);
-    std::string line;
-    while (getline(ss, line)) {
-      leftTextLines.push_back(line);
-      leftTextLinesCount++;
-    }
+  CaptureSnapshot(frameSnapshot);
+  DrawSnapshot(frameSnapshot);
+}
+
+void Camera::PublishSnapshot() {
+  CaptureSnapshot(snapshots.GetBack());
+  snapshots.Publish();
+}
+
+bool Camera::DrawLatestSnapshot() {
+  if (snapshots.Acquire()) {
+    hasSnapshot = true;
+  } else if (!hasSnapshot) {
+    return false;
+  } else if (lastFrameValid) {
+    return true; // The console still shows the newest snapshot
   }
-  int topTextLinesCount = 0;
-  int bottomTextLinesCount = 0;
+  DrawSnapshot(snapshots.GetFront());
+  return true;
+}
 
-  vector<std::string> topTextLines;
-  vector<std::string> bottomTextLines;
-  
-  if (!Camera::topText.empty()) {
-    stringstream ss(Camera::topText);
-    std::string line;
-    while (getline(ss, line)) {
-      topTextLines.push_back(line);
-      ++topTextLinesCount;
-    }
+// Runs on the game thread, the only writer of activeCameras, so the list
+// is read without the lock
+void PublishRenderSnapshots() {
+  for (Camera *camera : activeCameras) {
+    if (camera && camera->isRunningCam) camera->PublishSnapshot();
   }
+}
+
+// Non-UI first, then far to near, ties in id order
+static bool DrawsBefore(const DrawOrder::Key &a, const DrawOrder::Key &b) {
+  if (a.isUI != b.isUI) return !a.isUI;
+  if (a.depth != b.depth) return a.depth > b.depth;
+  return a.id < b.id;
+}
 
-  if (!Camera::bottomText.empty()) {
-    stringstream ss(Camera::bottomText);
-    std::string line;
-    while (getline(ss, line)) {
-      bottomTextLines.push_back(line);
-      ++bottomTextLinesCount;
+const std::vector<int> &DrawOrder::Update(const std::vector<Key> &keys) {
+  // Both lists are in id order, so one pass finds the unchanged keys
+  previousToCurrent.assign(previous.size(), -1);
+  fresh.clear();
+  size_t p = 0;
+  for (size_t c = 0; c < keys.size(); c++) {
+    while (p < previous.size() && previous[p].id < keys[c].id) p++;
+    if (p < previous.size() && previous[p].id == keys[c].id &&
+        previous[p].isUI == keys[c].isUI && previous[p].depth == keys[c].depth) {
+      previousToCurrent[p] = static_cast<int>(c);
+    } else {
+      fresh.push_back(static_cast<int>(c));
     }
   }
-  int maxLeftWidth = 0, maxRightWidth = 0;
-  for (const auto &line : leftTextLines) {
-    maxLeftWidth = std::max(maxLeftWidth, static_cast<int>(line.size()));
+
+  // Unchanged keys are still in order, only the rest need sorting
+  kept.clear();
+  for (int index : order) {
+    if (previousToCurrent[index] >= 0) kept.push_back(previousToCurrent[index]);
   }
-  for (const auto &line : rightTextLines) {
-    maxRightWidth = std::max(maxRightWidth, static_cast<int>(line.size()));
+  auto before = [&keys](int a, int b) { return DrawsBefore(keys[a], keys[b]); };
+  std::sort(fresh.begin(), fresh.end(), before);
+  sortedCount = fresh.size();
+
+  order.clear();
+  std::merge(kept.begin(), kept.end(), fresh.begin(), fresh.end(), std::back_inserter(order), before);
+  previous = keys;
+  return order;
+}
+
+// Splits the texts again if one of them changed, then shrinks cameraScale
+// to leave room for them and places the lines around the view
+void Camera::UpdateTextLayout(int consoleWidth, int consoleHeight, Vector3 &cameraScale) {
+  std::shared_ptr<const TextLayout> layout = textLayout;
+  std::shared_ptr<TextLayout> built;
+  if (!layout || layout->topText != topText || layout->bottomText != bottomText ||
+      layout->leftText != leftText || layout->rightText != rightText) {
+    built = std::make_shared<TextLayout>();
+    built->topText = topText;
+    built->bottomText = bottomText;
+    built->leftText = leftText;
+    built->rightText = rightText;
+    SplitLines(topText, built->top);
+    SplitLines(bottomText, built->bottom);
+    SplitLines(leftText, built->left);
+    SplitLines(rightText, built->right);
+    built->maxLeftWidth = MaxWidth(built->left);
+    built->maxRightWidth = MaxWidth(built->right);
+    layout = built;
   }
-  
+
+  int maxLeftWidth = layout->maxLeftWidth, maxRightWidth = layout->maxRightWidth;
+  int topTextLinesCount = layout->top.size();
+  int bottomTextLinesCount = layout->bottom.size();
   if (consoleWidth > maxLeftWidth + maxRightWidth + cameraScale.x) cameraScale -= maxLeftWidth + maxRightWidth;
   if (consoleHeight > topTextLinesCount + bottomTextLinesCount + cameraScale.y) cameraScale -= topTextLinesCount + bottomTextLinesCount;
-    
-  
-  if (cameraScale.x == 0 || cameraScale.y == 0 ||
-      cameraScale.z == 0)
-    return;
-    
-  // Detect console scale changes
-  if (consoleWidth != previousConsoleWidth ||
-      consoleHeight != previousConsoleHeight) {
-    Clear(); // Clear console to handle size changes
-    previousConsoleWidth = consoleWidth;
-    previousConsoleHeight = consoleHeight;
-  }
-  float hierarchy = this->hierarchy; // Default value if hierarchy is not found
-
-  // Fetch hierarchy from active cameras in CameraManager
- 
 
-  // Prepare the renderBuffer for rendering
-  std::vector<std::vector<std::string>> renderBuffer(cameraScale.y, std::vector<std::string>(cameraScale.x, "\0"));
-
-  for (int row = 0; row < renderBuffer.size(); row++) {
-    for (int str = 0; str < renderBuffer[row].size(); str++) {
-      if (row % static_cast<int>(patternOccurrenceRate.y) == 0 &&
-          str % static_cast<int>(patternOccurrenceRate.x) == 0 &&
-          renderBuffer[row][str] == "\0") {
-        
-        // Fill from renderBuffer[row][str] to the length of backgroundPattern
-        size_t patternLength = backgroundPattern.size();
-        for (size_t i = 0; i < patternLength; ++i) {
-          if (str + i < renderBuffer[row].size()) {
-            renderBuffer[row][str + i] = backgroundPattern[i];
-          }
-        }
-        // Skip to the end of the pattern length
-        str += patternLength - 1;
-      } else {
-        renderBuffer[row][str] = " ";
-      }
+  if (built || layout->viewWidth != cameraScale.x || layout->viewHeight != cameraScale.y ||
+      layout->topAlign != topAlign || layout->bottomAlign != bottomAlign ||
+      layout->leftAlign != leftAlign || layout->rightAlign != rightAlign) {
+    if (!built) {
+      built = std::make_shared<TextLayout>(*layout);
+      layout = built;
+    }
+    built->viewWidth = cameraScale.x;
+    built->viewHeight = cameraScale.y;
+    built->topAlign = topAlign;
+    built->bottomAlign = bottomAlign;
+    built->leftAlign = leftAlign;
+    built->rightAlign = rightAlign;
+
+    int viewLeft = maxLeftWidth;
+    int viewWidth = cameraScale.x;
+    for (TextLine &line : built->top) {
+      line.x = viewLeft + (cameraScale.x - line.cells.size()) * topAlign;
     }
+    for (TextLine &line : built->bottom) {
+      line.x = viewLeft + (cameraScale.x - line.cells.size()) * bottomAlign;
+    }
+    // Left text is right-aligned against the view, right text left-aligned
+    for (TextLine &line : built->left) line.x = viewLeft - static_cast<int>(line.cells.size());
+    for (TextLine &line : built->right) line.x = viewLeft + viewWidth;
+    built->leftRow = (cameraScale.y - built->left.size()) * leftAlign;
+    built->rightRow = (cameraScale.y - built->right.size()) * rightAlign;
   }
+  textLayout = layout;
+}
+
+void Camera::CaptureSnapshot(RenderSnapshot &snapshot) {
+  snapshot.visible = false;
+  snapshot.sprites.clear();
+
+  std::shared_ptr<TerminalSurface> target = GetSurface();
+  auto consoleSize = target->GetSize();
+  int consoleWidth = consoleSize.x;
+  int consoleHeight = consoleSize.y;
+  snapshot.consoleWidth = consoleWidth;
+  snapshot.consoleHeight = consoleHeight;
   
-  if (showOutOfStagePatterns) {
-    for (int row = 0; row < renderBuffer.size(); row++) {
-      for (int str = 0; str < renderBuffer[row].size(); str++) {
-        if (row % static_cast<int>(patternOccurrenceRate.y) == 0 &&
-          str % static_cast<int>(patternOccurrenceRate.x) == 0 &&
-          renderBuffer[row][str] == "\0") {
-        
-          // Fill from renderBuffer[row][str] to the length of backgroundPattern
-          size_t patternLength = outOfStagePattern.size();
-          for (size_t i = 0; i < patternLength; ++i) {
-            if (str + i < renderBuffer[row].size()) {
-              renderBuffer[row][str + i] = outOfStagePattern[i];
-            }
-          }
-          // Skip to the end of the pattern length
-          str += patternLength - 1;
-        } else {
-          renderBuffer[row][str] = " ";
-        }
-      }
-    }
+  Vector3 cameraScale = scale;
+  Vector3 cameraDisplayPosition = displayPosition;
+  
+  if(useRelativeTransform) {
+    cameraScale.x = consoleWidth * cameraRect.width;
+    cameraScale.y = consoleHeight * cameraRect.height;
+    cameraDisplayPosition.x = (consoleWidth + 1) * cameraRect.x;
+    cameraDisplayPosition.y = (consoleHeight + 1) * cameraRect.y;
   }
 
-  int worldRangeMinX = StageArea.x;
-  int worldRangeMaxX = StageArea.x + StageArea.width - 1;
-  int worldRangeMinY = StageArea.y;
-  int worldRangeMaxY = StageArea.y + StageArea.height - 1;
+  UpdateTextLayout(consoleWidth, consoleHeight, cameraScale);
+  snapshot.text = textLayout;
+
+  if (cameraScale.x == 0 || cameraScale.y == 0 ||
+      cameraScale.z == 0)
+    return;
 
-  float radians = rotation * (PI / 180.0);
-  float cosTheta = cos(radians);
-  float sinTheta = sin(radians);
+  snapshot.visible = true;
+  snapshot.cameraScale = cameraScale;
+  snapshot.cameraDisplayPosition = cameraDisplayPosition;
+  snapshot.position = position;
+  snapshot.rotation = rotation;
+  snapshot.anchor = anchor;
+  snapshot.backgroundPattern = backgroundPattern;
+  snapshot.patternOccurrenceRate = patternOccurrenceRate;
+  snapshot.showOutOfStagePatterns = showOutOfStagePatterns;
+  snapshot.sideLimit = sideLimit;
+  snapshot.drawMouse = !hideMouse;
+  snapshot.mouseX = cursorPositionX;
+  snapshot.mouseY = cursorPositionY;
+  snapshot.mouseIcon = mouseIcon;
+
+  if (static_cast<int>(cameraScale.x) <= 0 || static_cast<int>(cameraScale.y) <= 0)
+    return; // Nothing to cull against, the frame is still drawn
 
-  vector<std::shared_ptr<Actor>> Viewable;
   double angle = rotation; // Camera's rotation angle in radians
   double cosAngle = std::cos(angle);
   double sinAngle = std::sin(angle);
@@ -231,20 +326,38 @@ void Camera::RenderFrame() {
     return Vector2((rotatedX + center.x), (rotatedY + center.y));
   };
   
-  for (const auto entry : Workspace) {
-    auto obj = entry.second;
+  // Only look at actors filed under the grid cells the view overlaps. A
+  // rotated view is padded to a square that holds it at any angle, plus the
+  // widest actor so rotated bounds that reach into the view are kept.
+  double reachLeft = abs(cameraScale.x - cameraScale.x / 2), reachRight = abs(cameraScale.x / 2);
+  double reachUp = abs(cameraScale.y - cameraScale.y / 2), reachDown = abs(cameraScale.y / 2);
+  Rect viewArea(position.x - reachLeft, position.y - reachUp,
+                reachLeft + reachRight, reachUp + reachDown);
+  if (sinAngle != 0 || cosAngle != 1) {
+    double reach = std::hypot(std::max(reachLeft, reachRight), std::max(reachUp, reachDown)) +
+                   2 * WorkspaceIndex.GetLargestExtent();
+    viewArea = Rect(position.x - reach, position.y - reach, 2 * reach, 2 * reach);
+  }
+  WorkspaceIndex.Query(viewArea, visibleIDs);
+
+  int flip = 1;
+  if (cameraScale.z < 0)
+    flip = -1;
+
+  culled.clear();
+  culledKeys.clear();
+  for (int id : visibleIDs) {
+    auto found = Workspace.find(id);
+    if (found == Workspace.end()) continue;
+    Actor *obj = found->second.get();
     Transform* objTransform = obj->GetComponent<Transform>();
     SpriteRenderer* objSpriteRenderer = obj->GetComponent<SpriteRenderer>();
     
     if(objTransform == nullptr || objSpriteRenderer == nullptr) continue;
 
-    Vector2 size = objSpriteRenderer->GetSize();
-    #ifdef DEVELOPPER_DEBUG_MODE
-      std::cout << "Actor Size: " << size.x << " " << size.y << std::endl;
-    #endif
-    Vector3 location = objTransform->position;
+    Vector3 location = objTransform->GetPosition();
 
-    Vector3 scale = objTransform->scale;
+    Vector3 scale = objTransform->GetScale();
 
     location.x = round(location.x);
     location.y = round(location.y);
@@ -258,24 +371,19 @@ void Camera::RenderFrame() {
     if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f) continue;
       
     // Check if the object is part of UI or SpriteRenderer
-    if (obj->GetComponent<UI>() != nullptr) {
-        location.x = round(obj->GetComponent<Transform>()->position.x + position.x - abs(cameraScale.x) / 2);
-        location.y = round(obj->GetComponent<Transform>()->position.y + position.y - abs(cameraScale.y) / 2);
+    bool isUI = obj->GetComponent<UI>() != nullptr;
+    if (isUI) {
+        location.x = round(objTransform->GetPosition().x + position.x - abs(cameraScale.x) / 2);
+        location.y = round(objTransform->GetPosition().y + position.y - abs(cameraScale.y) / 2);
     }
-    
 
-    auto spriteRenderer = obj->GetComponent<SpriteRenderer>();
-    auto transform = obj->GetComponent<Transform>();
- 
-    Vector2 pivot = obj->GetComponent<SpriteRenderer>()->pivot;
-
-    if (obj->GetComponent<SpriteRenderer>()->isTransparent) {
+    if (objSpriteRenderer->isTransparent) {
       continue; // Skip transparent objects
     }
 
     Vector2 r1, r2;
 
-    std::tuple<int, int, int, int> seek = obj->GetComponent<SpriteRenderer>()->GetPivotBounds();
+    std::tuple<int, int, int, int> seek = objSpriteRenderer->GetPivotBounds();
  
 
     Vector2 topLeft =
@@ -303,7 +411,7 @@ void Camera::RenderFrame() {
               (double)   std::max({topLeft.y, topRight.y, bottomLeft.y, bottomRight.y}));
 
     #ifdef DEVELOPPER_DEBUG_MODE
-      std::cout << "Actor Name: " << obj->name << std::flush;
+      std::cout << "Actor Name: " << obj->GetName() << std::flush;
       getchar();
     #endif
     // Apply camera scaling to the bounding box after rotation and flipping
@@ -316,40 +424,92 @@ void Camera::RenderFrame() {
       continue; // Skip object if it's out of bounds
     }
 
-    Viewable.push_back(obj);
+    culledKeys.push_back({id, isUI, objTransform->GetPosition().z - abs(scale.z) / 2 * flip});
+    culled.emplace_back();
+    SpriteDraw &draw = culled.back();
+    draw.id = id;
+    draw.position = objTransform->GetPosition();
+    draw.pivot = objSpriteRenderer->GetPivot();
+    draw.bounds = seek;
+    draw.cells = objSpriteRenderer->GetCellSource();
   }
 
-  // Sort objects based on their z position (for layering)
-  int flip = 1;
-  if (cameraScale.z < 0)
-    flip = -1;
-  std::stable_sort(Viewable.begin(), Viewable.end(),
-    [&](const std::shared_ptr<Actor> a, const std::shared_ptr<Actor> b) {
-        bool aIsUI = a->GetComponent<UI>() != nullptr;
-        bool bIsUI = b->GetComponent<UI>() != nullptr;
+  // Layer the objects by their z position
+  for (int index : drawOrder.Update(culledKeys)) {
+    snapshot.sprites.push_back(std::move(culled[index]));
+  }
+}
 
-        if (aIsUI != bIsUI)
-            return !aIsUI;
+// Only reads the snapshot and the camera's own frame state, so the video
+// thread can run it while the game thread changes the Workspace
+void Camera::DrawSnapshot(const RenderSnapshot &snapshot) {
+  if (!snapshot.visible) return;
+
+  std::shared_ptr<TerminalSurface> target = GetSurface();
+  int consoleWidth = snapshot.consoleWidth;
+  int consoleHeight = snapshot.consoleHeight;
+  Vector3 cameraScale = snapshot.cameraScale;
+  Vector3 position = snapshot.position;
+
+  const TextLayout &text = *snapshot.text;
+  int topTextLinesCount = text.top.size();
+  int bottomTextLinesCount = text.bottom.size();
+  int leftTextLinesCount = text.left.size();
+  int rightTextLinesCount = text.right.size();
+  int maxLeftWidth = text.maxLeftWidth;
+  int maxRightWidth = text.maxRightWidth;
+    
+  // Detect console scale changes
+  if (consoleWidth != previousConsoleWidth ||
+      consoleHeight != previousConsoleHeight) {
+    target->Clear(); // Clear console to handle size changes
+    consoleClearCount++;
+    previousConsoleWidth = consoleWidth;
+    previousConsoleHeight = consoleHeight;
+  }
+  int viewWidth = cameraScale.x;
+  int viewHeight = cameraScale.y;
+  if (viewWidth <= 0 || viewHeight <= 0)
+    return;
 
-        return a->GetComponent<Transform>()->position.z -
-                   abs(a->GetComponent<Transform>()->scale.z) / 2 * flip >
-               b->GetComponent<Transform>()->position.z -
-                   abs(b->GetComponent<Transform>()->scale.z) / 2 * flip;
-    });
+  int renderedHeight = viewHeight;
+  if (!snapshot.sideLimit) {
+    renderedHeight = std::max(
+        renderedHeight, std::max(leftTextLinesCount, rightTextLinesCount));
+  }
 
-  
-  for (const auto entry : Viewable) {
-    Vector3 pos = entry->GetComponent<Transform>()->position;
-    double rot = entry->GetComponent<Transform>()->rotation;
-    Vector3 scl = entry->GetComponent<Transform>()->scale;
-    Vector2 pivot = entry->GetComponent<SpriteRenderer>()->GetPivot();
+  // The frame buffer holds the top text, the view rows framed by the
+  // left and right text, then the bottom text
+  int viewLeft = maxLeftWidth;
+  int viewTop = topTextLinesCount;
+  frameBuffer.Resize(maxLeftWidth + viewWidth + maxRightWidth,
+                     topTextLinesCount + std::max(renderedHeight, viewHeight + bottomTextLinesCount));
+  frameBuffer.Fill(Cell());
+
+  UpdatePatternLayer(snapshot, viewWidth);
+
+  // Where each sprite lands once rotated into the view
+  double angle = snapshot.rotation; // Camera's rotation angle in radians
+  double cosAngle = std::cos(angle);
+  double sinAngle = std::sin(angle);
+
+  auto rotatePointAroundCenter = [&cosAngle, &sinAngle](Vector2 point, Vector2 center) {
+    // Translate point to origin, rotate, then translate back
+    double translatedX = point.x - center.x;
+    double translatedY = point.y - center.y;
+
+    double rotatedX = cosAngle * translatedX - sinAngle * translatedY;
+    double rotatedY = sinAngle * translatedX + cosAngle * translatedY;
+
+    return Vector2((rotatedX + center.x), (rotatedY + center.y));
+  };
 
-    // Calculate the object's size after rotation and scaling
-    Vector2 objectSize = entry->GetComponent<SpriteRenderer>()->GetSize();
+  drawCorners.clear();
+  for (const SpriteDraw &entry : snapshot.sprites) {
+    Vector3 pos = entry.position;
 
     // Calculate the bounding box of the object after rotation
-    Vector2 r1, r2;
-    std::tuple<int, int, int, int> seek = entry->GetComponent<SpriteRenderer>()->GetPivotBounds();
+    const std::tuple<int, int, int, int> &seek = entry.bounds;
     #ifdef DEVELOPPER_DEBUG_MODE
       printf("Pivot bounds: %d %d %d %d\n",get<0>(seek), get<1>(seek), get<2>(seek),get<3>(seek));
     #endif
@@ -365,242 +525,398 @@ void Camera::RenderFrame() {
     bottomLeft = rotatePointAroundCenter(bottomLeft, position );
     bottomRight = rotatePointAroundCenter(bottomRight, position );
 
-    // Update r1 and r2 based on the rotated corners
-    r1 = {std::min({topLeft.x, topRight.x, bottomLeft.x, bottomRight.x}),
-          std::min({topLeft.y, topRight.y, bottomLeft.y, bottomRight.y})};
-    r2 = {std::max({topLeft.x, topRight.x, bottomLeft.x, bottomRight.x}),
-          std::max({topLeft.y, topRight.y, bottomLeft.y, bottomRight.y})};
-    #ifdef DEVELOPPER_DEBUG_MODE
-      printf("Object Rect: %lf %lf %lf %lf\n",r1.x,r1.y,r2.x,r2.y);
-      getchar();
-    #endif
-    SpriteRenderer *sprite = entry->GetComponent<SpriteRenderer>();
-    // Render the object
-    for (int i = r1.x; i <= r2.x; i++) {
-      for (int j = r1.y; j <= r2.y; j++) {
-        Vector2 pivot = sprite->GetPivot();
-        //printf("[%d %d]", i,j);
-        std::string cellStr = sprite->GetCellString(i - pos.x + pivot.x, j - pos.y + pivot.y);
-        
-        // Calculate the screen position
-        int x = cameraScale.x - cameraScale.x / 2 + (i - position.x);
-        int y = cameraScale.y - cameraScale.y / 2 + (j - position.y);
+    // r1 and r2 are the top left and bottom right of the rotated corners
+    drawCorners.push_back(Vector2(std::min({topLeft.x, topRight.x, bottomLeft.x, bottomRight.x}),
+                                  std::min({topLeft.y, topRight.y, bottomLeft.y, bottomRight.y})));
+    drawCorners.push_back(Vector2(std::max({topLeft.x, topRight.x, bottomLeft.x, bottomRight.x}),
+                                  std::max({topLeft.y, topRight.y, bottomLeft.y, bottomRight.y})));
+  }
 
-        // Update the renderBuffer if the position is within bounds
-        if (y >= 0 && y < cameraScale.y && x >= 0 && x < cameraScale.x) {
-          std::string stripped = StripAnsi(cellStr);
-          if (stripped != " " && stripped!="\0")
-            renderBuffer[y][x] = cellStr;
-            
-        }
-        
-      }
-     
-    }
+  // Large views are split into bands of rows drawn on the thread pool.
+  // A band owns its rows and draws the sprites in order, so each cell sees
+  // the same writes as a serial pass and the frame does not change.
+  ThreadPool &pool = GetThreadPool();
+  int bandRows = viewHeight;
+  // On a single core the bands would only take turns with the pool workers
+  bool hasSpareCores = std::thread::hardware_concurrency() > 1;
+  if (viewWidth * viewHeight >= minParallelCells && hasSpareCores && pool.GetThreadCount() > 0) {
+    int bands = 2 * (pool.GetThreadCount() + 1); // Spare bands even out uneven rows
+    bandRows = std::max(minBandRows, (viewHeight + bands - 1) / bands);
   }
+  pool.ParallelFor(0, viewHeight, bandRows, [&](size_t top, size_t bottom) {
+    DrawBand(snapshot, static_cast<int>(top), static_cast<int>(bottom));
+  });
 
   #ifdef DEVELOPPER_DEBUG_MODE
       getchar();
   #endif
-  int mouseX = cursorPositionX;
-  int mouseY = cursorPositionY;
+  int mouseX = snapshot.mouseX;
+  int mouseY = snapshot.mouseY;
+  if (snapshot.drawMouse && mouseX >= 0 && mouseX < viewWidth && mouseY >= 0 && mouseY < viewHeight) {
+    frameBuffer.WriteText(viewLeft + mouseX, viewTop + mouseY, snapshot.mouseIcon, 1);
+  }
 
+  int tl = text.leftRow, tr = text.rightRow;
 
-  
+  for (int i = 0; i < topTextLinesCount; ++i) {
+    frameBuffer.WriteCells(text.top[i].x, i, text.top[i].cells);
+  }
 
-  int tl, tr;
+  for (int j = 0; j < renderedHeight; ++j) {
+    int row = viewTop + j;
+    Cell *cells = frameBuffer.Row(row);
 
-  tl = (cameraScale.y - leftTextLinesCount) * leftAlign;
+    std::fill(cells, cells + viewLeft, MakeCell(' '));
+    if (j - tl >= 0 && j - tl < leftTextLinesCount) {
+      frameBuffer.WriteCells(text.left[j - tl].x, row, text.left[j - tl].cells);
+    }
 
-  tr = (cameraScale.y - rightTextLinesCount) * rightAlign;
-  
-  Vector2 anchor = anchor.Clamp(Vector2(0,0), Vector2(1,1));
-  // Initialize offsets
-  int offsetX = cameraDisplayPosition.x + (consoleWidth - cameraScale.x/2) * anchor.x;
-  int offsetY = cameraDisplayPosition.y + (consoleHeight - cameraScale.y/2) * anchor.y;
-  
+    if (j >= viewHeight) {
+      std::fill(cells + viewLeft, cells + viewLeft + viewWidth, MakeCell(' '));
+    }
 
-  for (const auto &line : leftTextLines) {
-    maxLeftWidth = std::max(maxLeftWidth, static_cast<int>(line.size()));
+    std::fill(cells + viewLeft + viewWidth, cells + frameBuffer.GetWidth(), MakeCell(' '));
+    if (j - tr >= 0 && j - tr < rightTextLinesCount) {
+      frameBuffer.WriteCells(text.right[j - tr].x, row, text.right[j - tr].cells);
+    }
   }
 
-  
+  for (int i = 0; i < bottomTextLinesCount; ++i) {
+    frameBuffer.WriteCells(text.bottom[i].x, viewTop + viewHeight + i, text.bottom[i].cells);
+  }
+
+  Vector2 anchor = snapshot.anchor;
+  anchor = anchor.Clamp(Vector2(0,0), Vector2(1,1));
+  int offsetX = snapshot.cameraDisplayPosition.x + (consoleWidth - cameraScale.x/2) * anchor.x;
+  int offsetY = snapshot.cameraDisplayPosition.y + (consoleHeight - cameraScale.y/2) * anchor.y;
 
+  PresentFrame(*target, offsetX, offsetY, consoleWidth, consoleHeight);
+}
 
-  for (const auto &line : leftTextLines) {
-    maxLeftWidth = std::max(maxLeftWidth, static_cast<int>(line.size()));
+// Rebuilds the pattern rows when the pattern, its rate or the view width
+// changed. Rows whose index is a multiple of the vertical rate show the
+// pattern every horizontal rate cells, the others are blank.
+void Camera::UpdatePatternLayer(const RenderSnapshot &snapshot, int viewWidth) {
+  // The out of stage pass only draws over cells nothing was drawn on and
+  // the background pass leaves none, so with it on the view stays blank
+  static const std::string noPattern;
+  const std::string &pattern =
+      snapshot.showOutOfStagePatterns ? noPattern : snapshot.backgroundPattern;
+  int rateX = std::max(1, static_cast<int>(snapshot.patternOccurrenceRate.x));
+  int rateY = std::max(1, static_cast<int>(snapshot.patternOccurrenceRate.y));
+
+  PatternLayer &layer = patternLayer;
+  if (layer.width == viewWidth && layer.rateX == rateX && layer.rateY == rateY &&
+      layer.pattern == pattern) {
+    return;
+  }
+  layer.pattern = pattern;
+  layer.rateX = rateX;
+  layer.rateY = rateY;
+  layer.width = viewWidth;
+
+  layer.blankRow.assign(viewWidth, MakeCell(' '));
+  layer.patternRow = layer.blankRow;
+  if (pattern.empty()) return;
+  for (int str = 0; str < viewWidth; str++) {
+    if (str % rateX != 0) continue;
+    for (size_t i = 0; i < pattern.size() && str + i < static_cast<size_t>(viewWidth); ++i) {
+      layer.patternRow[str + i] = MakeCell(pattern[i]);
+    }
+    // Skip to the end of the pattern length
+    str += pattern.size() - 1;
   }
+}
 
-  int topTextOffsetX = offsetX;
+// Fills rows [top, bottom) of the view and draws the part of every sprite
+// that falls in them. Reads drawCorners, written by DrawSnapshot.
+void Camera::DrawBand(const RenderSnapshot &snapshot, int top, int bottom) {
+  Vector3 cameraScale = snapshot.cameraScale;
+  Vector3 position = snapshot.position;
+  int viewWidth = cameraScale.x;
+  int viewLeft = snapshot.text->maxLeftWidth;
+  int viewTop = snapshot.text->top.size();
+
+  // Rows of the cached pattern layer, copied in whole
+  for (int row = top; row < bottom; row++) {
+    const std::vector<Cell> &source =
+        row % patternLayer.rateY == 0 ? patternLayer.patternRow : patternLayer.blankRow;
+    std::copy(source.begin(), source.end(), frameBuffer.Row(viewTop + row) + viewLeft);
+  }
 
-  topTextOffsetX += maxLeftWidth;
+  SpriteCell scratch; // Cells that fall outside a sprite's raster
+  for (size_t s = 0; s < snapshot.sprites.size(); s++) {
+    const SpriteDraw &entry = snapshot.sprites[s];
+    Vector3 pos = entry.position;
+    Vector2 pivot = entry.pivot;
+    Vector2 r1 = drawCorners[2 * s], r2 = drawCorners[2 * s + 1];
+
+    // Rows of the object inside the band, screen rows never decrease with j
+    int firstRow = 0, lastRow = -1;
+    for (int j = r1.y; j <= r2.y; j++) {
+      int y = cameraScale.y - cameraScale.y / 2 + (j - position.y);
+      if (y < top) continue;
+      if (y >= bottom) break;
+      if (lastRow < firstRow) firstRow = j;
+      lastRow = j;
+    }
+    if (lastRow < firstRow) continue;
 
-  
+    // Render the object
+    for (int i = r1.x; i <= r2.x; i++) {
+      // Calculate the screen position
+      int x = cameraScale.x - cameraScale.x / 2 + (i - position.x);
+      if (x < 0 || x >= viewWidth) continue;
 
-  // Precompute frequently used values
-  int maxConsoleWidth = consoleWidth;
-  int maxConsoleHeight = consoleHeight;
-  int cameraWidth = cameraScale.x;
-
-  int renderedHeight = cameraScale.y;
-  for (int i = 0; i < topTextLines.size(); ++i) {
-      int lineOffsetX = offsetX + maxLeftWidth;
-      lineOffsetX += (cameraScale.x - topTextLines[i].size()) * topAlign;
-      int currentY = offsetY + i;
-
-      if (currentY >= 0 && currentY < consoleHeight) {
-          if (lineOffsetX < consoleWidth) {
-              int maxWidth = consoleWidth - lineOffsetX; // Max characters that fit in the line
-              string slicedText = topTextLines[i].substr(0, maxWidth);
-              Gotoxy(lineOffsetX, currentY);
-              cout << slicedText << flush;
-          }
+      for (int j = firstRow; j <= lastRow; j++) {
+        int y = cameraScale.y - cameraScale.y / 2 + (j - position.y);
+        const SpriteCell &cell = entry.cells.GetCell(i - pos.x + pivot.x, j - pos.y + pivot.y, scratch);
+        if (cell.visible)
+          frameBuffer.At(viewLeft + x, viewTop + y) = cell.cell;
       }
+    }
   }
+}
 
+// Bytes PresentFrame writes to go from one style to another: a reset
+// unless coming from the default style, then the new style's sequence
+static int StyleSwitchCost(uint16_t from, uint16_t to) {
+  if (from == to) return 0;
+  return GetStyleSequence(to).size() + (from != 0 ? 4 : 0);
+}
 
-  if (!sideLimit) {
+// Bytes a cell costs when the previous cell had the given style
+static int CellCost(const Cell &cell, uint16_t previousStyle) {
+  int cost = cell.codepoint < 0x80 || (cell.flags & CELL_RAW) ? 1
+             : cell.codepoint < 0x800 ? 2
+             : cell.codepoint < 0x10000 ? 3 : 4;
+  return cost + StyleSwitchCost(previousStyle, cell.style);
+}
 
-    renderedHeight = std::max(
-        renderedHeight, std::max(leftTextLinesCount, rightTextLinesCount));
+static int DigitCount(int value) {
+  int digits = 1;
+  while (value >= 10) {
+    value /= 10;
+    digits++;
   }
+  return digits;
+}
 
-  for (int j = 0; j < renderedHeight; ++j) {
-    string leftLine =
-      (j - tl < leftTextLines.size() && j - tl >= 0)
-        ? leftTextLines[j - tl]
-        : "";
-    leftLine = string(maxLeftWidth - leftLine.size(), ' ') + leftLine;
-
-    string rightLine =
-      (j - tr < rightTextLines.size() && j - tr >= 0)
-        ? rightTextLines[j - tr]
-        : "";
-    rightLine += string(maxRightWidth - rightLine.size(), ' ');
-
-    string line = leftLine;
-    int availableWidth = consoleWidth - offsetX - maxRightWidth;
-
-    if (j < cameraScale.y) {
-      for (int i = 0; i < cameraScale.x; ++i) {
-        string cellContent = (!(hideMouse || hideMouse) && i == mouseX && j == mouseY) ? mouseIcon : renderBuffer[j][i];
-
-        if (i > availableWidth) break;
-        line += cellContent;
-      }
-    } else {
-     line += string(max(0, min((int)cameraScale.x, availableWidth - (int)line.size())), ' ');
-
-    }
-    line += rightLine;
+// Bytes of "\033[row;colH"
+static int CursorMoveCost(int x, int y) {
+  return 4 + DigitCount(y + 1) + DigitCount(x + 1);
+}
 
+static void AppendNumber(std::string &out, int value) {
+  char digits[12];
+  int length = 0;
+  do {
+    digits[length++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  while (length > 0) out += digits[--length];
+}
 
-    int currentY = offsetY + j + topTextLinesCount;
-    if (currentY >= 0 && currentY < consoleHeight) {
-      Gotoxy(offsetX, currentY);
-      cout << line << flush;
-    }
-  }
+// Writes the cells that changed since lastFrame, clipped to the console.
+// Nearby changes are merged into one run when rewriting the unchanged
+// cells between them, and switching to the next change's style from the
+// last of them, is no dearer than moving the cursor to that change and
+// switching to its style from the run's. The frame is
+// assembled into one buffer, SGR sequences are only emitted where the
+// style changes, and the result goes out in a single write.
+void Camera::PresentFrame(TerminalSurface &target, int offsetX, int offsetY, int consoleWidth, int consoleHeight) {
+  int width = frameBuffer.GetWidth();
+  int height = frameBuffer.GetHeight();
+
+  bool fullRedraw = !lastFrameValid || lastFrameX != offsetX ||
+                    lastFrameY != offsetY || lastFrameClears != consoleClearCount ||
+                    lastFrame.GetWidth() != width || lastFrame.GetHeight() != height;
+
+  auto changed = [&](int x, int y) {
+    const Cell &cell = frameBuffer.At(x, y);
+    if (cell.flags & CELL_SKIP) return false;
+    return fullRedraw || cell != lastFrame.At(x, y);
+  };
 
+  frameOutput.clear();
+  uint16_t currentStyle = 0;
 
+  for (int y = 0; y < height; y++) {
+    int screenY = offsetY + y;
+    if (screenY < 0 || screenY >= consoleHeight) continue;
 
-  // Render bottomText
-  for (int i = 0; i < bottomTextLines.size(); ++i) {
-    int lineOffsetX = offsetX + maxLeftWidth;
+    const Cell *cells = frameBuffer.Row(y);
+    int x = std::max(0, -offsetX);
+    int end = std::min(width, consoleWidth - offsetX);
 
+    while (x < end) {
+      if (!changed(x, y)) {
+        x++;
+        continue;
+      }
 
-     lineOffsetX += (cameraScale.x - bottomTextLines[i].size()) * bottomAlign;
-    // Calculate the vertical position for bottom text
-    int currentY = offsetY + cameraScale.y + topTextLinesCount + i;
+      int runStart = x;
+      int runEnd = x + 1;
+      while (true) {
+        while (runEnd < end && changed(runEnd, y)) runEnd++;
+
+        // Look for the next change and price the cells in between
+        uint16_t runStyle = cells[runEnd - 1].style;
+        uint16_t bridgeStyle = runStyle;
+        int bridgeCost = 0;
+        int next = runEnd;
+        while (next < end && !changed(next, y)) {
+          if (cells[next].flags & CELL_SKIP) break;
+          bridgeCost += CellCost(cells[next], bridgeStyle);
+          bridgeStyle = cells[next].style;
+          next++;
+        }
+        if (next >= end || next == runEnd || !changed(next, y)) break;
 
-    // Skip lines completely out of console bounds
-    if (currentY < 0 || currentY >= consoleHeight)
-      continue;
+        // Either way the next change's glyph is written, so it is left out
+        uint16_t nextStyle = cells[next].style;
+        int jumpCost = CursorMoveCost(offsetX + next, screenY) + StyleSwitchCost(runStyle, nextStyle);
+        if (bridgeCost + StyleSwitchCost(bridgeStyle, nextStyle) > jumpCost) break;
+        runEnd = next + 1;
+      }
 
-    // Truncate line content to fit console width
-    std::string truncatedLine = bottomTextLines[i];
-    if (lineOffsetX + truncatedLine.size() > consoleWidth) {
-      truncatedLine = truncatedLine.substr(0, consoleWidth - lineOffsetX);
+      frameOutput += "\033[";
+      AppendNumber(frameOutput, screenY + 1);
+      frameOutput += ';';
+      AppendNumber(frameOutput, offsetX + runStart + 1);
+      frameOutput += 'H';
+
+      for (int i = runStart; i < runEnd; i++) {
+        if (cells[i].style != currentStyle) {
+          // Styles are cumulative SGR sequences, so reset before switching
+          if (currentStyle != 0) frameOutput += "\033[0m";
+          frameOutput += GetStyleSequence(cells[i].style);
+          currentStyle = cells[i].style;
+        }
+        AppendGlyph(frameOutput, cells[i]);
+      }
+      x = runEnd;
     }
+  }
+  if (currentStyle != 0) frameOutput += "\033[0m";
 
-    // Skip rendering if completely out of bounds
-    if (lineOffsetX >= consoleWidth || lineOffsetX + truncatedLine.size() <= 0)
-      continue;
+  frameStats.bytes = frameOutput.size();
+  frameStats.writes = frameOutput.empty() ? 0 : target.Write(frameOutput);
 
-    // Move cursor and print the line
-    Gotoxy(std::max(0, lineOffsetX), currentY);
-    std::cout << truncatedLine << std::flush;
-  }
+  lastFrame = frameBuffer;
+  lastFrameX = offsetX;
+  lastFrameY = offsetY;
+  lastFrameClears = consoleClearCount;
+  lastFrameValid = true;
+}
+
+void Camera::InvalidateFrame() {
+  lastFrameValid = false;
 }
 
 void CleanupAndExit() {
-  for (size_t i = 0; i < activeCameras.size(); i++) {
-      if (activeCameras[i]) {
-          activeCameras[i]->StopVideo();
-      }
+  // StopVideo removes each camera from the list
+  std::vector<Camera *> cameras = activeCameras;
+  for (Camera *camera : cameras) {
+      if (camera) camera->StopVideo();
   }
 
   Clear();
 
   if (isRunning.load()) {
       isRunning.store(false);
-      WaitForSingleObject(videoThread, INFINITE);
-      CloseHandle(videoThread);
+      if (videoThread.thread.joinable()) videoThread.thread.join();
   }
 
-  ExitProcess(0);
+  std::exit(0);
 }
 
-void Camera::ShakeCameraOnce(float intensity) {
-  float offsetX =
-      intensity * ((rand() % 100 / 100) * (rand() % 2 == 0 ? 1 : -1));
-  float offsetY =
-      intensity * ((rand() % 100 / 100) * (rand() % 2 == 0 ? 1 : -1));
+Camera::~Camera() {
+  StopShake();
+  if (!isRunningCam) return;
+  std::lock_guard<std::mutex> lock(camerasMutex);
+  activeCameras.erase(std::remove(activeCameras.begin(), activeCameras.end(), this),
+                      activeCameras.end());
+}
 
-  position.x += static_cast<int>(offsetX);
-  position.y += static_cast<int>(offsetY);
+// Random offset of up to intensity cells either way
+static float ShakeOffset(float intensity) {
+  return intensity * (rand() % 100 / 100.0f) * (rand() % 2 == 0 ? 1 : -1);
+}
+
+void Camera::ShakeCameraOnce(float intensity) {
+  position.x += static_cast<int>(ShakeOffset(intensity));
+  position.y += static_cast<int>(ShakeOffset(intensity));
 }
 
 void Camera::ShakeCamera(float intensity, int shakes,
                          float delayBetweenShakes) {
-  float originalX = position.x;
-  float originalY = position.y;
-
-  for (int i = 0; i < shakes; ++i) {
-    float offsetX = intensity * (rand() % 100 / 100 - 0);
-    float offsetY = intensity * (rand() % 100 / 100 - 0);
-
-    position.x = originalX + (int)offsetX;
-    position.y = originalY + (int)offsetY;
-
-    Wait(delayBetweenShakes);
+  StopShake();
+  if (shakes <= 0) return;
+  shakeOrigin = position;
+
+  // Nothing would advance a script, so block as ShakeCamera always did
+  if (!AreScriptsUpdating()) {
+    for (int i = 0; i < shakes; i++) {
+      position.x = shakeOrigin.x + static_cast<int>(ShakeOffset(intensity));
+      position.y = shakeOrigin.y + static_cast<int>(ShakeOffset(intensity));
+      if (isRunningCam) PublishSnapshot();
+      Wait(static_cast<int>(delayBetweenShakes));
+    }
+    position.x = shakeOrigin.x;
+    position.y = shakeOrigin.y;
+    if (isRunningCam) PublishSnapshot();
+    return;
   }
 
-  position.x = originalX;
-  position.y = originalY;
+  Script shake;
+  shake.Do([this, intensity]() {
+         position.x = shakeOrigin.x + static_cast<int>(ShakeOffset(intensity));
+         position.y = shakeOrigin.y + static_cast<int>(ShakeOffset(intensity));
+       })
+      .WaitSeconds(delayBetweenShakes / 1000.0)
+      .Loop(shakes - 1)
+      .Do([this]() {
+        position.x = shakeOrigin.x;
+        position.y = shakeOrigin.y;
+        shakeScript = -1;
+      });
+  shakeScript = RunScript(shake);
 }
 
-DWORD WINAPI VideoThreadFunction(LPVOID lpParam) {
-  while (isRunning) {
-      auto startTime = GetTickCount(); // Get the start time in milliseconds
+void Camera::StopShake() {
+  if (shakeScript < 0) return;
+  StopScript(shakeScript);
+  shakeScript = -1;
+  position.x = shakeOrigin.x;
+  position.y = shakeOrigin.y;
+}
 
-      // Process cameras
-      if (activeCameras.empty()) {
-          break; // Stop the loop if there are no active cameras
-      }
+static void VideoThreadFunction() {
+  while (isRunning) {
+      auto startTime = std::chrono::steady_clock::now();
+
+      {
+          std::lock_guard<std::mutex> lock(camerasMutex);
+          // Stop the loop if there are no active cameras
+          if (activeCameras.empty()) {
+              isRunning = false;
+              break;
+          }
 
-      for (auto camera : activeCameras) {
-          if (camera && camera->isRunningCam) {
-              camera->RenderFrame();
+          for (auto camera : activeCameras) {
+              if (camera && camera->isRunningCam) {
+                  // Cameras may draw over each other, so only a lone camera
+                  // can trust that the console still shows its last frame
+                  if (activeCameras.size() > 1) camera->InvalidateFrame();
+                  camera->DrawLatestSnapshot();
+              }
           }
       }
 
       // Sleep to maintain FPS
-      DWORD frameTime = GetTickCount() - startTime;
-      DWORD delay = (1000 / FPS) > frameTime ? (1000 / FPS) - frameTime : 0;
-      Sleep(delay);
+      std::this_thread::sleep_until(startTime + std::chrono::milliseconds(static_cast<int>(1000 / FPS)));
   }
-  return 0;
 }
 
 void StartVideoProcessing() {
@@ -610,15 +926,17 @@ void StartVideoProcessing() {
 
   isRunning = true;
 
-  // Create the video processing thread using Windows API
-  videoThread = CreateThread(NULL, 0, VideoThreadFunction, NULL, 0, NULL);
-
-  if (videoThread == NULL) {
+  // Any previous thread was told to stop when isRunning was cleared
+  if (videoThread.thread.joinable()) videoThread.thread.join();
+  try {
+      videoThread.thread = std::thread(VideoThreadFunction);
+  } catch (const std::system_error &) {
       isRunning = false; // Rollback if thread creation fails
   }
 }
 
 void AddCamera(Camera *camera) {
+  std::unique_lock<std::mutex> lock(camerasMutex);
 
   // Check if the camera is already in the activeCameras vector
   auto it =
@@ -638,6 +956,7 @@ void AddCamera(Camera *camera) {
                const Camera* b) {
               return a->hierarchy > b->hierarchy;
             });
+  lock.unlock();
 
   // Start the video processing if it's not already running
   StartVideoProcessing();
@@ -647,6 +966,8 @@ void AddCamera(Camera *camera) {
 void Camera::StartVideo() {
 
   if (!isRunningCam) {
+    // The video thread only draws snapshots, so give it one to start from
+    PublishSnapshot();
     isRunningCam = true;
 
     // Register the camera with the CameraManager, passing the hierarchy
@@ -655,7 +976,8 @@ void Camera::StartVideo() {
 }
 
 void Camera::StopVideo() {
-  auto consoleSize = GetConsoleSize();
+  std::shared_ptr<TerminalSurface> target = GetSurface();
+  auto consoleSize = target->GetSize();
   int consoleWidth = consoleSize.x;
   int consoleHeight = consoleSize.y;
 
@@ -669,32 +991,23 @@ void Camera::StopVideo() {
       cameraDisplayPosition.y = consoleHeight * cameraRect.y;
   }
 
-  // No mutex, directly modifying isRunningCam
   if (isRunningCam) {
+      // Waits for a video pass that may be drawing this camera
+      std::lock_guard<std::mutex> lock(camerasMutex);
       isRunningCam = false;
+      InvalidateFrame();
 
       auto it = std::find_if(
           activeCameras.begin(), activeCameras.end(),
           [this](const Camera* camera) { return camera == this; });
 
       if (it != activeCameras.end()) {
-          HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-          COORD pos;
-
           // Clean the camera region on the console
-          for (int y = cameraDisplayPosition.y - cameraScale.y / 2;
-               y < cameraDisplayPosition.y + cameraScale.y - cameraScale.y / 2;
-               y++) {
-              pos.Y = y;
-              pos.X = cameraDisplayPosition.x - cameraScale.x / 2;
-              SetConsoleCursorPosition(hConsole, pos);
-              
-              for (int x = cameraDisplayPosition.x - cameraScale.x / 2;
-                   x < cameraDisplayPosition.x + cameraScale.x - cameraScale.x / 2;
-                   x++) {
-                  std::cout << " " << std::flush;
-              }
-          }
+          int left = cameraDisplayPosition.x - cameraScale.x / 2;
+          int top = cameraDisplayPosition.y - cameraScale.y / 2;
+          int right = cameraDisplayPosition.x + cameraScale.x - cameraScale.x / 2;
+          int bottom = cameraDisplayPosition.y + cameraScale.y - cameraScale.y / 2;
+          EraseRegion(*target, left, top, right - left, bottom - top);
 
           // Remove the camera from activeCameras list
           activeCameras.erase(it);
@@ -703,48 +1016,12 @@ void Camera::StopVideo() {
 }
 
 
-BOOL WINAPI SignalHandler(DWORD signal) {
-    if (signal == CTRL_C_EVENT) {
-        CleanupAndExit();
-    }
-    return TRUE;
-}
-
-DWORD WINAPI VideoProcessingLoop(LPVOID arg) {
-    LARGE_INTEGER frequency, lastFrameTime, now;
-    QueryPerformanceFrequency(&frequency);
-    QueryPerformanceCounter(&lastFrameTime);
-
-    while (isRunning.load()) {
-        QueryPerformanceCounter(&now);
-        double elapsed = (now.QuadPart - lastFrameTime.QuadPart) / (double)frequency.QuadPart;
-        
-        if (elapsed >= 1.0 / FPS) {
-            if (activeCameras.size() == 0) {
-                break;
-            }
-
-            for (size_t i = 0; i < activeCameras.size(); i++) {
-                if (activeCameras[i] && activeCameras[i]->isRunningCam) {
-                    activeCameras[i]->RenderFrame();
-                }
-            }
-
-            lastFrameTime = now;
-        }
-        Sleep(1000 / FPS);
-    }
-    return 0;
-}
-
-
-
 Vector3 Camera::getScale() {
     return scale;
 }
 
 Rect Camera::getCameraZone() {
-    auto consoleSize = GetConsoleSize();
+    auto consoleSize = GetSurface()->GetSize();
     int consoleWidth = consoleSize.x;
     int consoleHeight = consoleSize.y;
     
@@ -762,13 +1039,9 @@ Rect Camera::getCameraZone() {
 }
 
 void Camera::EraseCamera() {
+    InvalidateFrame();
     Rect cameraRegion = getCameraZone();
-    for (int j = 0; j < cameraRegion.height; j++) {
-        if (Gotoxy(cameraRegion.x, j + cameraRegion.y)) {
-            std::string clearLine(cameraRegion.width, ' ');
-            std::cout << clearLine << std::flush;
-        }
-    }
+    EraseRegion(*GetSurface(), cameraRegion.x, cameraRegion.y, cameraRegion.width, cameraRegion.height);
 }
 
 void Camera::setScale(Vector3 scale) {
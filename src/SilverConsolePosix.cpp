@@ -0,0 +1,56 @@
+#include "Silver.hpp"
+#include <cstdio>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Console backend for hosts without the Windows console API: the size
+// comes from the tty, output goes to stdout. CMake builds this file
+// everywhere but Windows, in place of SilverConsoleWin32.cpp.
+
+void ConsoleSurface::Refresh() {
+  int width = 80, height = 25; // Default fallback size, also when not a tty
+  winsize window;
+  sizeQueries++;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) == 0 && window.ws_col > 0 && window.ws_row > 0) {
+    width = window.ws_col;
+    height = window.ws_row;
+  }
+  StoreSize(width, height);
+}
+
+int ConsoleSurface::Write(const std::string &bytes) {
+  fflush(stdout); // Keep ordering with anything still buffered by cout/printf
+
+  int writes = 0;
+  size_t offset = 0;
+  while (offset < bytes.size()) {
+    writes++;
+    ssize_t written = write(STDOUT_FILENO, bytes.data() + offset, bytes.size() - offset);
+    if (written <= 0) break;
+    offset += static_cast<size_t>(written);
+  }
+  return writes;
+}
+
+void ConsoleSurface::Clear() {
+  Write("\033[2J\033[H");
+}
+
+// Terminals only report key presses as text, never which keys are held
+void LiveInputSource::Read(InputFrame &frame) { frame.keys = KeySet(); }
+
+static void SetTerminalFlags(tcflag_t flags, bool enabled) {
+  termios settings;
+  if (tcgetattr(STDIN_FILENO, &settings) != 0) return;
+  if (enabled) {
+    settings.c_lflag |= flags;
+  } else {
+    settings.c_lflag &= ~flags;
+  }
+  tcsetattr(STDIN_FILENO, TCSANOW, &settings);
+}
+
+void setRawMode(bool value) { SetTerminalFlags(ECHO | ICANON, !value); }
+
+void setNonBlockingMode(bool value) { SetTerminalFlags(ICANON, !value); }
@@ -0,0 +1,87 @@
+#include "Silver.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <windows.h>
+
+// Console backend for Windows. CMake builds this file only on Windows,
+// SilverConsolePosix.cpp takes its place elsewhere.
+
+void ConsoleSurface::Refresh() {
+  int width = 80, height = 25; // Default fallback size
+  CONSOLE_SCREEN_BUFFER_INFO csbi;
+  sizeQueries++;
+  if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) {
+    width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+    height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+  }
+  StoreSize(width, height);
+}
+
+// Writes the whole buffer with as few calls as the console allows
+int ConsoleSurface::Write(const std::string &bytes) {
+  fflush(stdout); // Keep ordering with anything still buffered by cout/printf
+
+  HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+  int writes = 0;
+  size_t offset = 0;
+  while (offset < bytes.size()) {
+    DWORD written = 0;
+    writes++;
+    if (!WriteFile(hConsole, bytes.data() + offset,
+                   static_cast<DWORD>(bytes.size() - offset), &written, NULL) ||
+        written == 0) {
+      break;
+    }
+    offset += written;
+  }
+  return writes;
+}
+
+void ConsoleSurface::Clear() {
+  fflush(stdout);
+  system("cls");
+}
+
+void LiveInputSource::Read(InputFrame &frame) {
+  frame.keys = KeySet();
+  for (int i = 0; i < 256; i++) {
+    if (GetAsyncKeyState(i) & 0x8000) frame.keys.Set(i, true);
+  }
+}
+
+void setRawMode(bool value) {
+  HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
+  DWORD mode;
+  GetConsoleMode(hInput, &mode);
+
+  if (value) {
+      mode &= ~(ENABLE_ECHO_INPUT | ENABLE_LINE_INPUT);
+  } else {
+      mode |= (ENABLE_ECHO_INPUT | ENABLE_LINE_INPUT);
+  }
+
+  SetConsoleMode(hInput, mode);
+}
+
+void setNonBlockingMode(bool value) {
+  HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
+  DWORD mode;
+  GetConsoleMode(hInput, &mode);
+
+  if (value) {
+      mode &= ~ENABLE_LINE_INPUT;  // Disable line buffering
+  } else {
+      mode |= ENABLE_LINE_INPUT;   // Restore line buffering
+  }
+
+  SetConsoleMode(hInput, mode);
+}
+
+void CleanupAndExit();
+
+BOOL WINAPI SignalHandler(DWORD signal) {
+    if (signal == CTRL_C_EVENT) {
+        CleanupAndExit();
+    }
+    return TRUE;
+}
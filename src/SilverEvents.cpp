@@ -0,0 +1,88 @@
+#include "Silver.hpp"
+#include <algorithm>
+
+InputBus InputEvents;
+
+int InputBus::Subscribe(InputEventType type, int key, InputCallback callback, bool onPool) {
+  auto subscription = std::make_shared<Subscription>();
+  subscription->bucket = BucketKey(type, key);
+  subscription->callback = std::move(callback);
+  subscription->onPool = onPool;
+
+  std::lock_guard<std::mutex> lock(busMutex);
+  subscription->id = nextID++;
+  buckets[subscription->bucket].push_back(subscription);
+  subscriptionBuckets[subscription->id] = subscription->bucket;
+  typeCounts[static_cast<int>(type)]++;
+  return subscription->id;
+}
+
+void InputBus::Unsubscribe(int id) {
+  std::lock_guard<std::mutex> lock(busMutex);
+  auto found = subscriptionBuckets.find(id);
+  if (found == subscriptionBuckets.end()) return;
+
+  std::vector<std::shared_ptr<Subscription>> &bucket = buckets[found->second];
+  for (size_t i = 0; i < bucket.size(); i++) {
+    if (bucket[i]->id != id) continue;
+    bucket[i]->active = false; // Already collected copies see this
+    bucket[i] = bucket.back();
+    bucket.pop_back();
+    break;
+  }
+  if (bucket.empty()) buckets.erase(found->second);
+
+  typeCounts[found->second >> 16]--;
+  subscriptionBuckets.erase(found);
+}
+
+void InputBus::Clear() {
+  std::lock_guard<std::mutex> lock(busMutex);
+  for (auto &bucket : buckets) {
+    for (auto &subscription : bucket.second) subscription->active = false;
+  }
+  buckets.clear();
+  subscriptionBuckets.clear();
+  for (auto &count : typeCounts) count = 0;
+}
+
+bool InputBus::HasSubscribers(InputEventType type) const {
+  return typeCounts[static_cast<int>(type)].load() > 0;
+}
+
+size_t InputBus::GetSubscriptionCount() {
+  std::lock_guard<std::mutex> lock(busMutex);
+  return subscriptionBuckets.size();
+}
+
+// Call with the bus locked
+void InputBus::Collect(int bucket, std::vector<std::shared_ptr<Subscription>> &out) {
+  auto found = buckets.find(bucket);
+  if (found != buckets.end()) out.insert(out.end(), found->second.begin(), found->second.end());
+}
+
+void InputBus::Publish(const InputEvent &event) {
+  if (!HasSubscribers(event.type)) return;
+
+  // Callbacks run unlocked, so they may subscribe and unsubscribe
+  std::vector<std::shared_ptr<Subscription>> targets;
+  {
+    std::lock_guard<std::mutex> lock(busMutex);
+    Collect(BucketKey(event.type, event.key), targets);
+    if (event.key != -1) Collect(BucketKey(event.type, -1), targets);
+  }
+
+  for (const std::shared_ptr<Subscription> &subscription : targets) {
+    if (!subscription->active) continue;
+    if (!subscription->onPool) {
+      subscription->callback(event);
+      continue;
+    }
+
+    if (subscription->busy.exchange(true)) continue; // Previous event still running
+    GetThreadPool().Enqueue([subscription, event]() {
+      if (subscription->active) subscription->callback(event);
+      subscription->busy = false;
+    });
+  }
+}
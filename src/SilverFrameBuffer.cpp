@@ -0,0 +1,204 @@
+#include "SilverFrameBuffer.hpp"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Style table. A deque keeps returned references valid while it grows.
+static std::mutex styleMutex;
+static std::deque<std::string> styleSequences = {""};
+static std::unordered_map<std::string, uint16_t> styleIndex = {{"", 0}};
+
+uint16_t InternStyle(const std::string &sequence) {
+  if (sequence.empty()) return 0;
+
+  std::lock_guard<std::mutex> lock(styleMutex);
+  auto it = styleIndex.find(sequence);
+  if (it != styleIndex.end()) return it->second;
+
+  if (styleSequences.size() >= UINT16_MAX) return 0; // Table full, draw unstyled
+
+  uint16_t style = static_cast<uint16_t>(styleSequences.size());
+  styleSequences.push_back(sequence);
+  styleIndex[sequence] = style;
+  return style;
+}
+
+const std::string &GetStyleSequence(uint16_t style) {
+  std::lock_guard<std::mutex> lock(styleMutex);
+  if (style >= styleSequences.size()) return styleSequences[0];
+  return styleSequences[style];
+}
+
+Cell DecodeCell(const std::string &text, size_t &i, uint16_t style) {
+  unsigned char lead = text[i];
+  int length = 1;
+  char32_t codepoint = lead;
+
+  if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    codepoint = lead & 0x1F;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    codepoint = lead & 0x0F;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    codepoint = lead & 0x07;
+  }
+
+  if (length > 1) {
+    bool valid = i + length <= text.size();
+    for (int k = 1; valid && k < length; k++) {
+      unsigned char next = text[i + k];
+      if ((next & 0xC0) != 0x80) valid = false;
+      codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    if (!valid) {
+      length = 1;
+      codepoint = lead;
+    }
+  }
+
+  Cell cell;
+  cell.codepoint = codepoint;
+  cell.style = style;
+  cell.flags = (length == 1 && lead >= 0x80) ? CELL_RAW : 0;
+  i += length;
+  return cell;
+}
+
+void FrameBuffer::Resize(int width, int height) {
+  width = std::max(0, width);
+  height = std::max(0, height);
+  if (width == this->width && height == this->height) return;
+
+  this->width = width;
+  this->height = height;
+  cells.resize(static_cast<size_t>(width) * height);
+}
+
+void FrameBuffer::Fill(const Cell &cell) {
+  std::fill(cells.begin(), cells.end(), cell);
+}
+
+int FrameBuffer::WriteText(int x, int y, const std::string &text, int maxCells) {
+  std::string activeAnsi;
+  uint16_t style = 0;
+  int written = 0;
+
+  size_t i = 0;
+  while (i < text.size() && (maxCells < 0 || written < maxCells)) {
+    if (text[i] == '\033') {
+      size_t end = text.find('m', i);
+      if (end == std::string::npos) break;
+
+      std::string sequence = text.substr(i, end - i + 1);
+      if (sequence == "\033[0m") {
+        activeAnsi.clear();
+      } else {
+        activeAnsi += sequence;
+      }
+      style = InternStyle(activeAnsi);
+      i = end + 1;
+      continue;
+    }
+
+    Cell cell = DecodeCell(text, i, style);
+    if (Contains(x + written, y)) At(x + written, y) = cell;
+    written++;
+  }
+
+  return written;
+}
+
+void FrameBuffer::WriteCells(int x, int y, const std::vector<Cell> &text) {
+  if (y < 0 || y >= height) return;
+  int from = std::max(0, -x);
+  int to = std::min(static_cast<int>(text.size()), width - x);
+  if (from < to) std::copy(text.begin() + from, text.begin() + to, Row(y) + x + from);
+}
+
+Cell MakeCell(char glyph, uint16_t style) {
+  Cell cell;
+  cell.codepoint = static_cast<unsigned char>(glyph);
+  cell.style = style;
+  cell.flags = cell.codepoint >= 0x80 ? CELL_RAW : 0;
+  return cell;
+}
+
+Cell ParseCell(const std::string &cellString) {
+  std::string activeAnsi;
+  size_t i = 0;
+
+  while (i < cellString.size() && cellString[i] == '\033') {
+    size_t end = cellString.find('m', i);
+    if (end == std::string::npos) break;
+    activeAnsi += cellString.substr(i, end - i + 1);
+    i = end + 1;
+  }
+
+  if (i >= cellString.size()) return MakeCell(' ');
+  return DecodeCell(cellString, i, InternStyle(activeAnsi));
+}
+
+void AppendGlyph(std::string &out, const Cell &cell) {
+  char32_t c = cell.codepoint;
+  if (c < 0x80 || (cell.flags & CELL_RAW)) {
+    out += static_cast<char>(c);
+  } else if (c < 0x800) {
+    out += static_cast<char>(0xC0 | (c >> 6));
+    out += static_cast<char>(0x80 | (c & 0x3F));
+  } else if (c < 0x10000) {
+    out += static_cast<char>(0xE0 | (c >> 12));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (c & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (c >> 18));
+    out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (c & 0x3F));
+  }
+}
+
+int TextWidth(const std::string &text) {
+  int width = 0;
+  size_t i = 0;
+  while (i < text.size()) {
+    if (text[i] == '\033') {
+      size_t end = text.find('m', i);
+      if (end == std::string::npos) break;
+      i = end + 1;
+      continue;
+    }
+    DecodeCell(text, i, 0);
+    width++;
+  }
+  return width;
+}
+
+std::vector<Cell> DecodeText(const std::string &text) {
+  std::vector<Cell> cells;
+  std::string activeAnsi;
+  uint16_t style = 0;
+
+  size_t i = 0;
+  while (i < text.size()) {
+    if (text[i] == '\033') {
+      size_t end = text.find('m', i);
+      if (end == std::string::npos) break;
+
+      std::string sequence = text.substr(i, end - i + 1);
+      if (sequence == "\033[0m") {
+        activeAnsi.clear();
+      } else {
+        activeAnsi += sequence;
+      }
+      style = InternStyle(activeAnsi);
+      i = end + 1;
+      continue;
+    }
+    cells.push_back(DecodeCell(text, i, style));
+  }
+  return cells;
+}
@@ -0,0 +1,135 @@
+#include "SilverTerminal.hpp"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Kept free of <windows.h> so it builds wherever the renderer is tested
+
+static Cell BlankCell() {
+  return MakeCell(' ');
+}
+
+HeadlessSurface::HeadlessSurface(int width, int height) {
+  screen.Resize(width, height);
+  screen.Fill(BlankCell());
+}
+
+void HeadlessSurface::SetSize(int width, int height) {
+  {
+    std::lock_guard<std::mutex> lock(surfaceMutex);
+    screen.Resize(width, height);
+    screen.Fill(BlankCell());
+    cursorX = cursorY = 0;
+  }
+  NotifyResize(Vector2(width, height));
+}
+
+Vector2 HeadlessSurface::GetSize() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  return Vector2(screen.GetWidth(), screen.GetHeight());
+}
+
+int HeadlessSurface::Write(const std::string &bytes) {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  if (captureFrames) frames.push_back(bytes);
+  Apply(bytes);
+  return 1;
+}
+
+void HeadlessSurface::Clear() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  screen.Fill(BlankCell());
+  cursorX = cursorY = 0;
+}
+
+std::vector<std::string> HeadlessSurface::GetFrames() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  return frames;
+}
+
+void HeadlessSurface::ClearFrames() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  frames.clear();
+}
+
+void HeadlessSurface::SetCaptureFrames(bool value) {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  captureFrames = value;
+}
+
+std::string HeadlessSurface::GetScreenText() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  std::string text;
+  for (int y = 0; y < screen.GetHeight(); y++) {
+    for (int x = 0; x < screen.GetWidth(); x++) {
+      AppendGlyph(text, screen.At(x, y));
+    }
+    text += '\n';
+  }
+  return text;
+}
+
+Cell HeadlessSurface::GetCell(int x, int y) {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  if (!screen.Contains(x, y)) return BlankCell();
+  return screen.At(x, y);
+}
+
+// Understands what the engine emits: cursor moves (CSI row;col H),
+// SGR (CSI ... m), erase display (CSI J), newlines and UTF-8 text.
+// Text past the right edge is clipped.
+void HeadlessSurface::Apply(const std::string &bytes) {
+  size_t i = 0;
+  while (i < bytes.size()) {
+    char c = bytes[i];
+
+    if (c == '\033' && i + 1 < bytes.size() && bytes[i + 1] == '[') {
+      size_t end = i + 2;
+      while (end < bytes.size() && !((bytes[end] >= 'A' && bytes[end] <= 'Z') ||
+                                     (bytes[end] >= 'a' && bytes[end] <= 'z'))) {
+        end++;
+      }
+      if (end >= bytes.size()) break;
+
+      std::string params = bytes.substr(i + 2, end - i - 2);
+      char command = bytes[end];
+
+      if (command == 'H') {
+        int row = 1, column = 1;
+        size_t separator = params.find(';');
+        if (!params.empty() && separator != 0) row = std::atoi(params.c_str());
+        if (separator != std::string::npos) column = std::atoi(params.c_str() + separator + 1);
+        cursorY = row - 1;
+        cursorX = column - 1;
+      } else if (command == 'm') {
+        if (params.empty() || params == "0") {
+          activeAnsi.clear();
+        } else {
+          activeAnsi += bytes.substr(i, end - i + 1);
+        }
+        style = InternStyle(activeAnsi);
+      } else if (command == 'J') {
+        screen.Fill(BlankCell());
+      }
+
+      i = end + 1;
+      continue;
+    }
+
+    if (c == '\n') {
+      cursorY++;
+      cursorX = 0;
+      i++;
+      continue;
+    }
+    if (c == '\r') {
+      cursorX = 0;
+      i++;
+      continue;
+    }
+
+    Cell cell = DecodeCell(bytes, i, style);
+    if (screen.Contains(cursorX, cursorY)) screen.At(cursorX, cursorY) = cell;
+    cursorX++;
+  }
+}
@@ -0,0 +1,124 @@
+#include "SilverInput.hpp"
+#include <algorithm>
+#include <mutex>
+
+// Kept free of <windows.h> so recorded sessions replay wherever the
+// engine is benchmarked
+
+// Log layout: the magic and version, then per frame a flags byte followed
+// by whatever changed since the previous frame. Little endian throughout.
+static const char logMagic[4] = {'S', 'L', 'V', 'I'};
+static const uint8_t logVersion = 1;
+static const uint8_t keysChanged = 1;   // 4 x uint64 key words follow
+static const uint8_t cursorChanged = 2; // 2 x int32 cursor coordinates follow
+
+static std::mutex inputMutex;
+static std::shared_ptr<InputSource> activeSource;
+
+static std::ofstream recording;
+static InputFrame recordedFrame;
+
+static void WriteUint(std::ostream &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) out.put(static_cast<char>(value >> (8 * i) & 0xff));
+}
+
+static bool ReadUint(std::istream &in, uint64_t &value, int bytes) {
+  value = 0;
+  for (int i = 0; i < bytes; i++) {
+    int byte = in.get();
+    if (byte == EOF) return false;
+    value |= static_cast<uint64_t>(byte) << (8 * i);
+  }
+  return true;
+}
+
+void SetInputSource(std::shared_ptr<InputSource> source) {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  activeSource = source;
+}
+
+std::shared_ptr<InputSource> GetInputSource() {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  if (!activeSource) activeSource = std::make_shared<LiveInputSource>();
+  return activeSource;
+}
+
+bool StartInputRecording(const std::string &path) {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  if (recording.is_open()) recording.close();
+
+  recording.open(path, std::ios::binary | std::ios::trunc);
+  if (!recording) return false;
+  recording.write(logMagic, sizeof(logMagic));
+  recording.put(static_cast<char>(logVersion));
+  recordedFrame = InputFrame();
+  return true;
+}
+
+void StopInputRecording() {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  if (recording.is_open()) recording.close();
+}
+
+bool IsRecordingInput() {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  return recording.is_open();
+}
+
+void RecordInputFrame(const InputFrame &frame) {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  if (!recording.is_open()) return;
+
+  uint8_t flags = 0;
+  if (frame.keys != recordedFrame.keys) flags |= keysChanged;
+  if (frame.cursorX != recordedFrame.cursorX || frame.cursorY != recordedFrame.cursorY) {
+    flags |= cursorChanged;
+  }
+
+  recording.put(static_cast<char>(flags));
+  if (flags & keysChanged) {
+    for (uint64_t word : frame.keys.words) WriteUint(recording, word, 8);
+  }
+  if (flags & cursorChanged) {
+    WriteUint(recording, static_cast<uint32_t>(frame.cursorX), 4);
+    WriteUint(recording, static_cast<uint32_t>(frame.cursorY), 4);
+  }
+  recordedFrame = frame;
+}
+
+ReplayInputSource::ReplayInputSource(const std::string &path)
+    : file(path, std::ios::binary) {
+  char magic[sizeof(logMagic)] = {};
+  file.read(magic, sizeof(magic));
+  isOpen = file && std::equal(magic, magic + sizeof(magic), logMagic) && file.get() == logVersion;
+  finished = !isOpen;
+}
+
+void ReplayInputSource::Read(InputFrame &frame) {
+  if (finished) {
+    frame.keys = KeySet();
+    frame.cursorX = last.cursorX;
+    frame.cursorY = last.cursorY;
+    return;
+  }
+
+  int flags = file.get();
+  bool complete = flags != EOF;
+  if (complete && (flags & keysChanged)) {
+    for (uint64_t &word : last.keys.words) complete = complete && ReadUint(file, word, 8);
+  }
+  if (complete && (flags & cursorChanged)) {
+    uint64_t x = 0, y = 0;
+    complete = ReadUint(file, x, 4) && ReadUint(file, y, 4);
+    last.cursorX = static_cast<int32_t>(x);
+    last.cursorY = static_cast<int32_t>(y);
+  }
+
+  if (!complete) {
+    finished = true; // A truncated frame ends the replay too
+    Read(frame);
+    return;
+  }
+  framesRead++;
+  frame = last;
+}
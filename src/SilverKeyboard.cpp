@@ -1,16 +1,76 @@
 #include "SilverKeyboard.hpp"
-#include <windows.h>
+#include "SilverEvents.hpp"
+#include "SilverVMouse.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
+// Published key sets, written by PollEvents and read from any thread
+static std::atomic<uint64_t> keyStates[4];
+static std::atomic<uint64_t> keyDownStates[4];
+static std::atomic<uint64_t> keyUpStates[4];
+static std::atomic<bool> isInitialized{false};
+
+// Where the cursor was at the previous poll
+static int polledCursorX = 0, polledCursorY = 0;
+
+// Single producer (PollEvents), single consumer (DrainKeyTransitions) ring
+static const size_t transitionCapacity = 1024; // Power of two
+static KeyTransition transitions[transitionCapacity];
+static std::atomic<size_t> transitionHead{0}; // Next write, producer only
+static std::atomic<size_t> transitionTail{0}; // Next read, consumer only
+
+static std::mutex statsMutex;
+static PollStats pollStats;
+
+static KeySet LoadKeySet(const std::atomic<uint64_t> (&source)[4]) {
+    KeySet result;
+    for (int i = 0; i < 4; i++) result.words[i] = source[i].load(std::memory_order_relaxed);
+    return result;
+}
+
+static void StoreKeySet(std::atomic<uint64_t> (&target)[4], const KeySet &value) {
+    for (int i = 0; i < 4; i++) target[i].store(value.words[i], std::memory_order_relaxed);
+}
+
+static bool TestKey(const std::atomic<uint64_t> (&source)[4], int key) {
+    if (key < 0 || key >= 256) return false;
+    return (source[key >> 6].load(std::memory_order_relaxed) >> (key & 63) & 1) != 0;
+}
+
+// Returns false when the ring is full
+static bool PushTransition(const KeyTransition &transition) {
+    size_t head = transitionHead.load(std::memory_order_relaxed);
+    if (head - transitionTail.load(std::memory_order_acquire) == transitionCapacity) return false;
+    transitions[head & (transitionCapacity - 1)] = transition;
+    transitionHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t DrainKeyTransitions(std::vector<KeyTransition> &out) {
+    size_t tail = transitionTail.load(std::memory_order_relaxed);
+    size_t head = transitionHead.load(std::memory_order_acquire);
+    for (size_t i = tail; i != head; i++) out.push_back(transitions[i & (transitionCapacity - 1)]);
+    transitionTail.store(head, std::memory_order_release);
+    return head - tail;
+}
+
+// Calls func(key) for every key in set
+template <typename F> static void ForEachKey(const KeySet &set, F func) {
+    for (int word = 0; word < 4; word++) {
+        uint64_t bits = set.words[word];
+        for (int bit = 0; bits != 0; bit++, bits >>= 1) {
+            if (bits & 1) func(word * 64 + bit);
+        }
+    }
+}
 
 void InitializeKeyboardModule() {
-    if (!isInitialized) {
+    if (!isInitialized.exchange(true)) {
         // Initialize all key states to false
-        for (int i = 0; i < 256; i++) {
-            keyStates[i] = false;
-            keyDownStates[i] = false;
-            keyUpStates[i] = false;
-        }
-        isInitialized = true;
+        StoreKeySet(keyStates, KeySet());
+        StoreKeySet(keyDownStates, KeySet());
+        StoreKeySet(keyUpStates, KeySet());
         setNonBlockingMode(true);
     }
 }
@@ -19,36 +79,94 @@ void PollEvents() {
     if (!isInitialized) {
         InitializeKeyboardModule();
     }
+    RefreshConsoleSize(); // The one console size query of the frame
 
-    for (int i = 0; i < 256; i++) {
-        bool currentState = (GetAsyncKeyState(i) & 0x8000) != 0;
-        
-        // Detect key down (transition from not pressed to pressed)
-        if (currentState && !keyStates[i]) {
-            keyDownStates[i] = true;
-        } else {
-            keyDownStates[i] = false;
-        }
+    auto start = std::chrono::steady_clock::now();
 
-        // Detect key up (transition from pressed to not pressed)
-        if (!currentState && keyStates[i]) {
-            keyUpStates[i] = true;
-        } else {
-            keyUpStates[i] = false;
-        }
+    std::shared_ptr<InputSource> source = GetInputSource();
+    InputFrame frame;
+    frame.cursorX = cursorPositionX;
+    frame.cursorY = cursorPositionY;
+    source->Read(frame);
+    if (!source->ProvidesCursor()) {
+        StepVMouse(frame.keys);
+        frame.cursorX = cursorPositionX;
+        frame.cursorY = cursorPositionY;
+    }
+    cursorPositionX = frame.cursorX;
+    cursorPositionY = frame.cursorY;
+    RecordInputFrame(frame);
 
-        keyStates[i] = currentState;
+    const KeySet &current = frame.keys;
+
+    // Edges are a single mask per word
+    KeySet previous = LoadKeySet(keyStates);
+    KeySet down = current & ~previous;
+    KeySet up = ~current & previous;
+    StoreKeySet(keyStates, current);
+    StoreKeySet(keyDownStates, down);
+    StoreKeySet(keyUpStates, up);
+
+    int64_t timestamp =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+    uint64_t dropped = 0;
+    ForEachKey(down, [&](int key) {
+        if (!PushTransition({timestamp, static_cast<uint8_t>(key), true})) dropped++;
+    });
+    ForEachKey(up, [&](int key) {
+        if (!PushTransition({timestamp, static_cast<uint8_t>(key), false})) dropped++;
+    });
+
+    // Published after every key is updated, so callbacks see the whole poll
+    int cursorX = frame.cursorX, cursorY = frame.cursorY;
+    ForEachKey(down, [&](int key) {
+        InputEvents.Publish({InputEventType::KeyDown, key, cursorX, cursorY});
+    });
+    ForEachKey(up, [&](int key) {
+        InputEvents.Publish({InputEventType::KeyUp, key, cursorX, cursorY});
+    });
+    if (InputEvents.HasSubscribers(InputEventType::KeyHeld)) {
+        ForEachKey(current, [&](int key) {
+            InputEvents.Publish({InputEventType::KeyHeld, key, cursorX, cursorY});
+        });
     }
+
+    if (cursorX != polledCursorX || cursorY != polledCursorY) {
+        polledCursorX = cursorX;
+        polledCursorY = cursorY;
+        InputEvents.Publish({InputEventType::CursorMove, -1, cursorX, cursorY});
+    }
+    InputEvents.Publish({InputEventType::Frame, -1, cursorX, cursorY});
+
+    // Callbacks on the polling thread count toward the poll
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    pollStats.polls++;
+    pollStats.last = elapsed;
+    pollStats.average += (elapsed - pollStats.average) / pollStats.polls;
+    if (elapsed > pollStats.max) pollStats.max = elapsed;
+    pollStats.droppedTransitions += dropped;
 }
 
 bool IsKey(int key) {
-    return keyStates[key];
+    return TestKey(keyStates, key);
 }
 
 bool IsKeyDown(int key) {
-    return keyDownStates[key];
+    return TestKey(keyDownStates, key);
 }
 
 bool IsKeyUp(int key) {
-    return keyUpStates[key];
-}
\ No newline at end of file
+    return TestKey(keyUpStates, key);
+}
+
+KeySet GetKeyStates() { return LoadKeySet(keyStates); }
+
+KeySet GetKeysDown() { return LoadKeySet(keyDownStates); }
+
+KeySet GetKeysUp() { return LoadKeySet(keyUpStates); }
+
+PollStats GetPollStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return pollStats;
+}
@@ -2,17 +2,25 @@
 #include <fstream>
 #include <iostream>
 #include <cstring>
+#include <windows.h>
+#include <mmsystem.h>
+
+struct AudioPlayer::Device {
+    HWAVEOUT hWaveOut = NULL;
+    WAVEFORMATEX waveFormat;
+    WAVEHDR waveHeader;
+    std::unique_ptr<BYTE[]> audioData;
+    DWORD dataSize = 0;
+};
 
 
 AudioPlayer::AudioPlayer(const std::string& filePath) 
     : filePath(filePath),
-      hWaveOut(NULL),
-      audioData(nullptr),
-      dataSize(0),
+      device(new Device()),
       isPlaying(false),
       isPaused(false) {
-    memset(&waveFormat, 0, sizeof(WAVEFORMATEX));
-    memset(&waveHeader, 0, sizeof(WAVEHDR));
+    memset(&device->waveFormat, 0, sizeof(WAVEFORMATEX));
+    memset(&device->waveHeader, 0, sizeof(WAVEHDR));
 }
 
 AudioPlayer::~AudioPlayer() {
@@ -38,7 +46,7 @@ bool AudioPlayer::LoadWaveFile() {
 
     // Skip to format chunk
     file.seekg(16);
-    file.read(reinterpret_cast<char*>(&waveFormat), sizeof(WAVEFORMATEX));
+    file.read(reinterpret_cast<char*>(&device->waveFormat), sizeof(WAVEFORMATEX));
 
     // Find data chunk
     char chunkHeader[4];
@@ -59,9 +67,9 @@ bool AudioPlayer::LoadWaveFile() {
     }
 
     // Read audio data
-    dataSize = chunkSize;
-    audioData.reset(new BYTE[dataSize]);
-    file.read(reinterpret_cast<char*>(audioData.get()), dataSize);
+    device->dataSize = chunkSize;
+    device->audioData.reset(new BYTE[device->dataSize]);
+    file.read(reinterpret_cast<char*>(device->audioData.get()), device->dataSize);
 
     return true;
 }
@@ -73,16 +81,16 @@ void AudioPlayer::Play() {
         return;
     }
 
-    if (waveOutOpen(&hWaveOut, WAVE_MAPPER, &waveFormat, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) {
+    if (waveOutOpen(&device->hWaveOut, WAVE_MAPPER, &device->waveFormat, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) {
         std::cerr << "Failed to open audio device" << std::endl;
         return;
     }
 
-    waveHeader.lpData = reinterpret_cast<LPSTR>(audioData.get());
-    waveHeader.dwBufferLength = dataSize;
-    waveHeader.dwFlags = 0;
+    device->waveHeader.lpData = reinterpret_cast<LPSTR>(device->audioData.get());
+    device->waveHeader.dwBufferLength = device->dataSize;
+    device->waveHeader.dwFlags = 0;
 
-    if (waveOutPrepareHeader(hWaveOut, &waveHeader, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+    if (waveOutPrepareHeader(device->hWaveOut, &device->waveHeader, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
         std::cerr << "Failed to prepare header" << std::endl;
         return;
     }
@@ -90,14 +98,14 @@ void AudioPlayer::Play() {
     isPlaying = true;
     isPaused = false;
 
-    if (waveOutWrite(hWaveOut, &waveHeader, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+    if (waveOutWrite(device->hWaveOut, &device->waveHeader, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
         std::cerr << "Failed to start playback" << std::endl;
         isPlaying = false;
         return;
     }
 
     // Wait for playback to complete
-    while (isPlaying && (waveHeader.dwFlags & WHDR_DONE) == 0) {
+    while (isPlaying && (device->waveHeader.dwFlags & WHDR_DONE) == 0) {
         Sleep(100);
     }
 
@@ -105,42 +113,42 @@ void AudioPlayer::Play() {
 }
 
 void AudioPlayer::Stop() {
-    if (hWaveOut && isPlaying) {
-        waveOutReset(hWaveOut);
+    if (device->hWaveOut && isPlaying) {
+        waveOutReset(device->hWaveOut);
         isPlaying = false;
     }
 }
 
-void AudioPlayer::SetVolume(DWORD newVolume) {
-    if (hWaveOut) {
+void AudioPlayer::SetVolume(unsigned long newVolume) {
+    if (device->hWaveOut) {
         // Volume is 0-0xFFFF (left/right channels)
         DWORD volume = (newVolume << 16) | newVolume;
-        waveOutSetVolume(hWaveOut, volume);
+        waveOutSetVolume(device->hWaveOut, volume);
     }
 }
 
 void AudioPlayer::Pause() {
-    if (hWaveOut && isPlaying && !isPaused) {
-        waveOutPause(hWaveOut);
+    if (device->hWaveOut && isPlaying && !isPaused) {
+        waveOutPause(device->hWaveOut);
         isPaused = true;
     }
 }
 
 void AudioPlayer::Resume() {
-    if (hWaveOut && isPlaying && isPaused) {
-        waveOutRestart(hWaveOut);
+    if (device->hWaveOut && isPlaying && isPaused) {
+        waveOutRestart(device->hWaveOut);
         isPaused = false;
     }
 }
 
 void AudioPlayer::Cleanup() {
-    if (hWaveOut) {
-        if (waveHeader.dwFlags & WHDR_PREPARED) {
-            waveOutUnprepareHeader(hWaveOut, &waveHeader, sizeof(WAVEHDR));
+    if (device->hWaveOut) {
+        if (device->waveHeader.dwFlags & WHDR_PREPARED) {
+            waveOutUnprepareHeader(device->hWaveOut, &device->waveHeader, sizeof(WAVEHDR));
         }
-        waveOutClose(hWaveOut);
-        hWaveOut = NULL;
+        waveOutClose(device->hWaveOut);
+        device->hWaveOut = NULL;
     }
-    audioData.reset();
-    dataSize = 0;
+    device->audioData.reset();
+    device->dataSize = 0;
 }
\ No newline at end of file
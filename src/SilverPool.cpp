@@ -0,0 +1,69 @@
+#include "SilverPool.hpp"
+#include <algorithm>
+
+// Blocks carved from each chunk
+static const size_t blocksPerChunk = 256;
+
+BlockPool::BlockPool(size_t blockSize)
+    : blockSize(std::max(blockSize, sizeof(FreeBlock))) {}
+
+BlockPool::FreeBlock *BlockPool::Pop() {
+  if (freeList == nullptr) {
+    char *chunk = static_cast<char *>(::operator new(blockSize * blocksPerChunk));
+    chunks.push_back(chunk);
+
+    // Thread the new blocks onto the free list, first block on top
+    for (size_t i = blocksPerChunk; i-- > 0;) {
+      FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + i * blockSize);
+      block->next = freeList;
+      freeList = block;
+    }
+  }
+
+  FreeBlock *block = freeList;
+  freeList = block->next;
+  liveBlocks++;
+  return block;
+}
+
+void *BlockPool::Allocate() {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  return Pop();
+}
+
+void BlockPool::Release(void *block) {
+  if (block == nullptr) return;
+
+  std::lock_guard<std::mutex> lock(poolMutex);
+  FreeBlock *freed = static_cast<FreeBlock *>(block);
+  freed->next = freeList;
+  freeList = freed;
+  liveBlocks--;
+}
+
+void BlockPool::Refill(BlockList &list, size_t count) {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  for (size_t i = 0; i < count; i++) {
+    FreeBlock *block = Pop();
+    block->next = list.head;
+    list.head = block;
+  }
+  list.count += count;
+}
+
+void BlockPool::Drain(BlockList &list, size_t count) {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  for (size_t i = 0; i < count && list.head != nullptr; i++) {
+    FreeBlock *block = list.head;
+    list.head = block->next;
+    list.count--;
+    block->next = freeList;
+    freeList = block;
+    liveBlocks--;
+  }
+}
+
+size_t BlockPool::GetLiveBlocks() {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  return liveBlocks;
+}
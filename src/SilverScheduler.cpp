@@ -0,0 +1,160 @@
+#include "Silver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <typeinfo>
+
+Scheduler WorkspaceScheduler;
+
+// Components a pool thread claims at a time
+static const size_t chunkSize = 64;
+
+void Scheduler::SetStepMode(StepMode mode) {
+  stepMode = mode;
+  accumulator = 0;
+}
+
+void Scheduler::SetFixedStep(double seconds) {
+  if (seconds > 0) fixedStep = seconds;
+}
+
+void Scheduler::SetMaxSteps(int steps) { maxSteps = std::max(1, steps); }
+
+double Scheduler::GetStepAlpha() const {
+  if (stepMode != StepMode::Fixed) return 0;
+  return std::min(1.0, accumulator / fixedStep);
+}
+
+int Scheduler::Tick() {
+  auto now = std::chrono::steady_clock::now();
+  double deltaTime = ticked ? std::chrono::duration<double>(now - lastTick).count() : 0;
+  lastTick = now;
+  ticked = true;
+  return Tick(deltaTime);
+}
+
+int Scheduler::Tick(double deltaTime) {
+  auto start = std::chrono::steady_clock::now();
+  for (SystemTiming &timing : timings) {
+    timing.calls = 0;
+    timing.milliseconds = 0;
+  }
+
+  int steps = 0;
+  if (stepMode == StepMode::Variable) {
+    Gather();
+    Step(static_cast<float>(deltaTime));
+    steps = 1;
+  } else {
+    accumulator += std::max(0.0, deltaTime);
+    if (accumulator >= fixedStep) Gather();
+    while (accumulator >= fixedStep && steps < maxSteps) {
+      Step(static_cast<float>(fixedStep));
+      accumulator -= fixedStep;
+      steps++;
+    }
+    // Too far behind to catch up, drop whole steps rather than spiral
+    if (accumulator >= fixedStep) accumulator = std::fmod(accumulator, fixedStep);
+  }
+
+  // Types no longer in the Workspace drop out of the report
+  timings.erase(std::remove_if(timings.begin(), timings.end(),
+                               [](const SystemTiming &timing) { return timing.calls == 0; }),
+                timings.end());
+
+  actors.clear();
+  for (auto &group : groups) group.clear();
+  PublishRenderSnapshots();
+  tickMilliseconds =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return steps;
+}
+
+void Scheduler::Gather() {
+  actors.clear();
+  for (auto &group : groups) group.clear();
+
+  actors.reserve(Workspace.size());
+  for (const auto &entry : Workspace) {
+    Actor *actor = entry.second.get();
+    actors.push_back(entry.second);
+
+    const std::vector<Component *> &slots = actor->componentSlots;
+    if (groups.size() < slots.size()) groups.resize(slots.size());
+    for (size_t typeID = 0; typeID < slots.size(); typeID++) {
+      if (slots[typeID] != nullptr) groups[typeID].push_back({actor, slots[typeID]});
+    }
+  }
+
+  // Same order every tick, whatever the Workspace hash order
+  for (auto &group : groups) {
+    std::sort(group.begin(), group.end(), [](const Entry &a, const Entry &b) {
+      return a.actor->GetInstanceID() < b.actor->GetInstanceID();
+    });
+  }
+}
+
+void Scheduler::RunEntries(const Entry *entries, size_t count, size_t typeID, float deltaTime) {
+  for (size_t i = 0; i < count; i++) {
+    const std::vector<Component *> &slots = entries[i].actor->componentSlots;
+    // Removed earlier in the tick
+    if (typeID >= slots.size() || slots[typeID] != entries[i].component) continue;
+    entries[i].component->Update(deltaTime);
+  }
+}
+
+// The report entry for typeID, added on first use
+static SystemTiming &FindTiming(std::vector<SystemTiming> &timings, size_t typeID, const char *name) {
+  auto timing = std::find_if(timings.begin(), timings.end(),
+                             [typeID](const SystemTiming &t) { return t.typeID == typeID; });
+  if (timing != timings.end()) return *timing;
+
+  timings.push_back(SystemTiming());
+  timings.back().typeID = typeID;
+  timings.back().name = name;
+  return timings.back();
+}
+
+void Scheduler::Step(float deltaTime) {
+  for (size_t typeID = 0; typeID < groups.size(); typeID++) {
+    const std::vector<Entry> &group = groups[typeID];
+    if (group.empty()) continue;
+
+    SystemTiming *timing = &FindTiming(timings, typeID, typeid(*group.front().component).name());
+
+    bool parallel = group.size() > chunkSize && group.front().component->IsIndependent();
+    auto start = std::chrono::steady_clock::now();
+    if (parallel) {
+      GetThreadPool().ParallelFor(0, group.size(), chunkSize, [&](size_t begin, size_t end) {
+        RunEntries(group.data() + begin, end - begin, typeID, deltaTime);
+      });
+    } else {
+      RunEntries(group.data(), group.size(), typeID, deltaTime);
+    }
+
+    timing->parallel = parallel;
+    timing->calls += group.size();
+    timing->milliseconds +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  if (WorkspaceTimers.Size() > 0) {
+    auto start = std::chrono::steady_clock::now();
+    size_t fired = WorkspaceTimers.AdvanceBy(deltaTime);
+    SystemTiming &timing = FindTiming(timings, timerTimingID, "Timers");
+    timing.calls += fired;
+    timing.milliseconds +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  } else {
+    WorkspaceTimers.AdvanceBy(deltaTime); // Keeps the clock moving for later delays
+  }
+
+  size_t scripts = GetScriptCount();
+  if (scripts == 0) return;
+
+  auto start = std::chrono::steady_clock::now();
+  UpdateScripts(deltaTime);
+  SystemTiming &timing = FindTiming(timings, scriptTimingID, "Scripts");
+  timing.calls += scripts;
+  timing.milliseconds +=
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,224 @@
+#include "Silver.hpp"
+#include <chrono>
+#include <unordered_map>
+
+// What a running script keeps between ticks
+struct ScriptRun {
+  std::shared_ptr<const std::vector<Script::Step>> steps;
+  int id;
+  int actorID;
+  unsigned step = 0;
+  int loops = 0;     // Repeats done by the current Loop step
+  double waited = 0; // Seconds into the current wait
+};
+
+struct ScriptTable {
+  std::vector<ScriptRun> runs;
+  std::unordered_map<int, size_t> positions; // ID to index in runs
+  std::vector<ScriptRun> started;            // Started during UpdateScripts
+  int nextID = 0;
+  bool updating = false;
+  bool everUpdated = false;
+  std::chrono::steady_clock::time_point lastUpdate; // See AreScriptsUpdating
+};
+
+// Never destroyed, so components stopping their scripts during static
+// destruction still find it
+static ScriptTable &GetScripts() {
+  static ScriptTable *table = new ScriptTable();
+  return *table;
+}
+
+Script &Script::Add(Step step) {
+  // Copy on write, runs already started keep the steps they had
+  if (!steps || steps.use_count() > 1) {
+    steps = steps ? std::make_shared<std::vector<Step>>(*steps)
+                  : std::make_shared<std::vector<Step>>();
+  }
+  steps->push_back(std::move(step));
+  return *this;
+}
+
+Script &Script::Do(std::function<void()> action) {
+  Step step;
+  step.kind = Step::Action;
+  step.action = std::move(action);
+  return Add(std::move(step));
+}
+
+Script &Script::WaitSeconds(double seconds) {
+  Step step;
+  step.kind = Step::Wait;
+  step.seconds = seconds;
+  return Add(std::move(step));
+}
+
+Script &Script::NextFrame() {
+  Step step;
+  step.kind = Step::Frame;
+  return Add(std::move(step));
+}
+
+Script &Script::WaitUntil(std::function<bool()> condition) {
+  Step step;
+  step.kind = Step::Until;
+  step.condition = std::move(condition);
+  return Add(std::move(step));
+}
+
+Script &Script::Loop(int times) {
+  Step step;
+  step.kind = Step::Repeat;
+  step.times = times;
+  step.loopStart = loopStart;
+  Add(std::move(step));
+  loopStart = steps->size();
+  return *this;
+}
+
+int RunScript(const Script &script, int actorID) {
+  ScriptTable &table = GetScripts();
+  int id = table.nextID++;
+  if (!script.steps || script.steps->empty()) return id; // Nothing to do
+
+  ScriptRun run;
+  run.steps = script.steps;
+  run.id = id;
+  run.actorID = actorID;
+
+  if (table.updating) {
+    table.started.push_back(std::move(run));
+  } else {
+    table.positions[run.id] = table.runs.size();
+    table.runs.push_back(std::move(run));
+  }
+  return id;
+}
+
+static void EraseRun(ScriptTable &table, size_t index) {
+  table.positions.erase(table.runs[index].id);
+  if (index + 1 != table.runs.size()) {
+    table.runs[index] = std::move(table.runs.back());
+    table.positions[table.runs[index].id] = index;
+  }
+  table.runs.pop_back();
+}
+
+void StopScript(int id) {
+  ScriptTable &table = GetScripts();
+  auto found = table.positions.find(id);
+  if (found != table.positions.end()) {
+    // Mid-update the run is only marked, UpdateScripts erases it
+    if (table.updating) {
+      table.runs[found->second].steps = nullptr;
+    } else {
+      EraseRun(table, found->second);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < table.started.size(); i++) {
+    if (table.started[i].id != id) continue;
+    table.started.erase(table.started.begin() + i);
+    return;
+  }
+}
+
+bool IsScriptRunning(int id) {
+  ScriptTable &table = GetScripts();
+  auto found = table.positions.find(id);
+  if (found != table.positions.end()) return table.runs[found->second].steps != nullptr;
+  for (const ScriptRun &run : table.started) {
+    if (run.id == id) return true;
+  }
+  return false;
+}
+
+size_t GetScriptCount() {
+  ScriptTable &table = GetScripts();
+  return table.runs.size() + table.started.size();
+}
+
+// Runs steps until one has to wait. Returns false once the script ended.
+static bool Advance(ScriptRun &run, double deltaTime) {
+  // Keeps the steps alive while one of them stops this script
+  std::shared_ptr<const std::vector<Script::Step>> steps = run.steps;
+
+  // A pass over every step without waiting would spin forever on a Loop
+  size_t budget = steps->size() + 1;
+  bool waitedThisTick = false;
+
+  while (run.steps && run.step < steps->size()) {
+    if (budget-- == 0) return true;
+
+    const Script::Step &step = (*steps)[run.step];
+    switch (step.kind) {
+    case Script::Step::Action:
+      run.step++;
+      step.action(); // May stop this script, which clears run.steps
+      break;
+
+    case Script::Step::Wait:
+      if (!waitedThisTick) {
+        run.waited += deltaTime;
+        waitedThisTick = true;
+      }
+      if (run.waited < step.seconds) return true;
+      run.waited -= step.seconds; // The remainder carries over, keeping repeats on time
+      run.step++;
+      break;
+
+    case Script::Step::Frame:
+      run.step++;
+      return true;
+
+    case Script::Step::Until:
+      if (!step.condition()) return true;
+      run.step++;
+      break;
+
+    case Script::Step::Repeat:
+      if (step.times >= 0 && run.loops >= step.times) {
+        run.loops = 0;
+        run.step++;
+      } else {
+        run.loops++;
+        run.step = static_cast<unsigned>(step.loopStart);
+      }
+      break;
+    }
+  }
+  return false;
+}
+
+void UpdateScripts(double deltaTime) {
+  ScriptTable &table = GetScripts();
+  table.updating = true;
+  table.everUpdated = true;
+  table.lastUpdate = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < table.runs.size();) {
+    ScriptRun &run = table.runs[i];
+    bool alive = run.steps && (run.actorID < 0 || IsAlive(run.actorID));
+    if (alive) alive = Advance(run, deltaTime);
+
+    if (alive) {
+      i++;
+    } else {
+      EraseRun(table, i); // Moves the last run here, so i is not advanced
+    }
+  }
+
+  table.updating = false;
+  for (ScriptRun &run : table.started) {
+    table.positions[run.id] = table.runs.size();
+    table.runs.push_back(std::move(run));
+  }
+  table.started.clear();
+}
+
+bool AreScriptsUpdating() {
+  const ScriptTable &table = GetScripts();
+  return table.everUpdated &&
+         std::chrono::steady_clock::now() - table.lastUpdate < std::chrono::seconds(1);
+}
@@ -0,0 +1,211 @@
+#include "Silver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+SpatialIndex WorkspaceIndex;
+
+SpatialIndex::SpatialIndex(int cellSize) : cellSize(std::max(1, cellSize)) {}
+
+int SpatialIndex::CellCoord(double value) const {
+  return static_cast<int>(std::floor(value / cellSize));
+}
+
+void SpatialIndex::Insert(int id) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  Entry &entry = entries[id];
+  if (!entry.dirty) {
+    entry.dirty = true;
+    dirty.push_back(id);
+  }
+}
+
+void SpatialIndex::MarkDirty(int id) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  auto it = entries.find(id);
+  if (it == entries.end() || it->second.dirty) return;
+  it->second.dirty = true;
+  dirty.push_back(id);
+}
+
+void SpatialIndex::MarkDirty(const std::vector<int> &ids) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  for (int id : ids) {
+    auto it = entries.find(id);
+    if (it == entries.end() || it->second.dirty) continue;
+    it->second.dirty = true;
+    dirty.push_back(id);
+  }
+}
+
+void SpatialIndex::Remove(int id) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  auto it = entries.find(id);
+  if (it == entries.end()) return;
+  Unlink(id, it->second);
+  entries.erase(it); // A stale id left in the dirty list is skipped later
+}
+
+void SpatialIndex::Remove(const std::vector<int> &ids) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  for (int id : ids) {
+    auto it = entries.find(id);
+    if (it == entries.end()) continue;
+    Unlink(id, it->second);
+    entries.erase(it);
+  }
+}
+
+void SpatialIndex::Clear() {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  cells.clear();
+  entries.clear();
+  uiActors.clear();
+  dirty.clear();
+  largestExtent = 0;
+}
+
+size_t SpatialIndex::Size() {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  return entries.size();
+}
+
+double SpatialIndex::GetLargestExtent() {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  FlushDirty();
+  return largestExtent;
+}
+
+// Takes the entry out of the grid cells and the UI list
+void SpatialIndex::Unlink(int id, Entry &entry) {
+  if (entry.isUI) {
+    auto it = std::find(uiActors.begin(), uiActors.end(), id);
+    if (it != uiActors.end()) {
+      *it = uiActors.back();
+      uiActors.pop_back();
+    }
+    entry.isUI = false;
+  }
+
+  if (!entry.inGrid) return;
+  for (int y = entry.minY; y <= entry.maxY; y++) {
+    for (int x = entry.minX; x <= entry.maxX; x++) {
+      auto cell = cells.find(CellKey(x, y));
+      if (cell == cells.end()) continue;
+
+      std::vector<int> &ids = cell->second;
+      auto it = std::find(ids.begin(), ids.end(), id);
+      if (it != ids.end()) {
+        *it = ids.back();
+        ids.pop_back();
+      }
+      if (ids.empty()) cells.erase(cell);
+    }
+  }
+  entry.inGrid = false;
+}
+
+// Re-reads the actor's bounds the same way the camera culls it
+void SpatialIndex::Refresh(int id, Entry &entry) {
+  auto actor = Workspace.find(id);
+  if (actor == Workspace.end()) return;
+
+  Transform *transform = actor->second->GetComponent<Transform>();
+  SpriteRenderer *sprite = actor->second->GetComponent<SpriteRenderer>();
+  if (transform == nullptr || sprite == nullptr) {
+    Unlink(id, entry);
+    return;
+  }
+
+  if (actor->second->GetComponent<UI>() != nullptr) {
+    Unlink(id, entry);
+    entry.isUI = true;
+    uiActors.push_back(id);
+    return;
+  }
+
+  std::tuple<int, int, int, int> seek = sprite->GetPivotBounds();
+  Vector3 position = transform->GetPosition();
+  double x = std::round(position.x);
+  double y = std::round(position.y);
+  double left = x - std::get<0>(seek), right = x + std::get<1>(seek);
+  double top = y - std::get<2>(seek), bottom = y + std::get<3>(seek);
+
+  largestExtent = std::max(largestExtent, std::max(right - left, bottom - top) / 2);
+
+  int minX = CellCoord(left), maxX = CellCoord(right);
+  int minY = CellCoord(top), maxY = CellCoord(bottom);
+  if (entry.inGrid && !entry.isUI && minX == entry.minX && maxX == entry.maxX &&
+      minY == entry.minY && maxY == entry.maxY) {
+    return; // Still covers the same cells
+  }
+
+  Unlink(id, entry);
+  for (int cy = minY; cy <= maxY; cy++) {
+    for (int cx = minX; cx <= maxX; cx++) {
+      cells[CellKey(cx, cy)].push_back(id);
+    }
+  }
+  entry.minX = minX;
+  entry.maxX = maxX;
+  entry.minY = minY;
+  entry.maxY = maxY;
+  entry.inGrid = true;
+}
+
+void SpatialIndex::FlushDirty() {
+  for (int id : dirty) {
+    auto it = entries.find(id);
+    if (it == entries.end() || !it->second.dirty) continue;
+    it->second.dirty = false;
+    Refresh(id, it->second);
+  }
+  dirty.clear();
+}
+
+void SpatialIndex::Query(const Rect &area, std::vector<int> &out) {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  FlushDirty();
+
+  out.clear();
+  out.insert(out.end(), uiActors.begin(), uiActors.end());
+
+  // Stamps let actors spanning several cells be reported once
+  if (++queryStamp == 0) {
+    for (auto &entry : entries) entry.second.queryStamp = 0;
+    queryStamp = 1;
+  }
+
+  int minX = CellCoord(area.x), maxX = CellCoord(area.x + area.width);
+  int minY = CellCoord(area.y), maxY = CellCoord(area.y + area.height);
+
+  // A view wider than the populated grid is cheaper to answer by walking the cells
+  if (static_cast<size_t>(maxX - minX + 1) * (maxY - minY + 1) > cells.size()) {
+    for (auto &cell : cells) {
+      int x = static_cast<int>(static_cast<uint32_t>(cell.first >> 32));
+      int y = static_cast<int>(static_cast<uint32_t>(cell.first));
+      if (x < minX || x > maxX || y < minY || y > maxY) continue;
+      for (int id : cell.second) {
+        Entry &entry = entries[id];
+        if (entry.queryStamp == queryStamp) continue;
+        entry.queryStamp = queryStamp;
+        out.push_back(id);
+      }
+    }
+  } else {
+    for (int y = minY; y <= maxY; y++) {
+      for (int x = minX; x <= maxX; x++) {
+        auto cell = cells.find(CellKey(x, y));
+        if (cell == cells.end()) continue;
+        for (int id : cell->second) {
+          Entry &entry = entries[id];
+          if (entry.queryStamp == queryStamp) continue;
+          entry.queryStamp = queryStamp;
+          out.push_back(id);
+        }
+      }
+    }
+  }
+
+  std::sort(out.begin(), out.end());
+}
@@ -1,8 +1,13 @@
 #include "Silver.hpp"
-#include <vector>
-#include <string>
-#include <stack>
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 
 // Function to strip ANSI escape codes
@@ -72,18 +77,12 @@ Vector2 SpriteRenderer::GetPivot() {
 }
 
 Vector2 SpriteRenderer::GetSize() {
-    auto transform = parent->GetComponent<Transform>();
-    double rotation = transform->rotation;
-    Vector3 scale = transform->scale;
+    Transform *transform = parent ? parent->GetComponent<Transform>() : nullptr;
+    double rotation = transform ? transform->GetRotation() : 0;
+    Vector3 scale = transform ? transform->GetScale() : Vector3(1, 1, 1);
 
     // Get the untransformed size of the cleaned shape
-    int height = 0, width = 0;
-    
-    std::string line;
-    while (std::getline(ss, line, '\n')) {
-        height++;
-        width = std::max(width, static_cast<int>(line.size()));
-    }
+    int height = GetAsset().height, width = GetAsset().width;
 
     // Edge case: Empty shape
     if (width == 0 || height == 0) {
@@ -132,20 +131,18 @@ Vector2 SpriteRenderer::GetSize() {
 
 
 
-Vector2 SpriteRenderer::RotatePoint(double column, double line) {
-  Vector2 pivot = this->GetPivot();
-  int height = 0, width = 0;
-  
-  std::string l;
-  while (std::getline(ss, l, '\n')) {
-      height++;
-      width = std::max(width, static_cast<int>(l.size()));
-  }
-  if(useRelativePivot) pivot = Vector2(static_cast<int>(std::round(this->pivotFactor.x * width)), static_cast<int>(std::round(this->pivotFactor.y * height)));
-    
-  auto transform = (parent->GetComponent<Transform>());
+// Stands in for the asset of a sprite with no shape
+static const SpriteAsset &EmptySpriteAsset() {
+  static const SpriteAsset emptyAsset;
+  return emptyAsset;
+}
+
+// Rotates a cell of the unscaled shape around the key's pivot
+static Vector2 RotateAroundPivot(const SpriteRasterKey &key, double column, double line) {
+  // Same pivot as ComputeCellString, so the bounds match the drawn cells
+  Vector2 pivot = key.pivot;
 
-  double rotation = transform->rotation;
+  double rotation = key.rotation;
   // Calculate local coordinates relative to the pivot
   int localX = column - pivot.x;
   int localY = line - pivot.y;
@@ -162,27 +159,24 @@ Vector2 SpriteRenderer::RotatePoint(double column, double line) {
   return Vector2(rotatedX, rotatedY);
 }
 
-std::tuple<int, int, int, int> SpriteRenderer::CalculatePivotExpansion() {
-    Vector2 pivot = this->GetPivot();
-    std::string shape = this->shape;
-
-    auto transform = parent->GetComponent<Transform>();
-    Vector3 scale = transform->scale;
+static std::tuple<int, int, int, int> PivotExpansion(const SpriteAsset &data, const SpriteRasterKey &key) {
+    Vector2 pivot = key.pivot;
+    Vector3 scale = key.scale;
 
     // Determine shape dimensions
     
 
-    if (useRelativePivot) {
-        pivot = Vector2(std::round(this->pivotFactor.x * spriteWidth), std::round(this->pivotFactor.y * spriteHeight));
+    if (key.useRelativePivot) {
+        pivot = Vector2(std::round(key.pivotFactor.x * data.width), std::round(key.pivotFactor.y * data.height));
     }
 
-    Vector2 size((double) spriteWidth, (double) spriteHeight);
+    Vector2 size((double) data.width, (double) data.height);
 
     // Get rotated corner positions
-    Vector2 leftUp = RotatePoint(0, 0);
-    Vector2 leftDown = RotatePoint(0, size.y - 1);
-    Vector2 rightDown = RotatePoint(size.x - 1, size.y - 1);
-    Vector2 rightUp = RotatePoint(size.x - 1, 0);
+    Vector2 leftUp = RotateAroundPivot(key, 0, 0);
+    Vector2 leftDown = RotateAroundPivot(key, 0, size.y - 1);
+    Vector2 rightDown = RotateAroundPivot(key, size.x - 1, size.y - 1);
+    Vector2 rightUp = RotateAroundPivot(key, size.x - 1, 0);
 
     // Compute bounding box
     double lb = std::min({leftUp.x, leftDown.x, rightDown.x, rightUp.x});
@@ -212,69 +206,12 @@ std::tuple<int, int, int, int> SpriteRenderer::CalculatePivotExpansion() {
     return std::make_tuple(fl, fr, fu, fd);
 }
 
-std::tuple<int, int, int, int> SpriteRenderer::GetPivotBounds() {
-    Vector2 pivot = this->GetPivot();
-    std::string shape = this->shape;
-
-    auto transform = parent->GetComponent<Transform>();
-    Vector3 scale = transform->scale;
-
-    
-
-    Vector2 size((double)spriteWidth, (double)spriteHeight);
-    
-    // Get rotated corner positions
-    Vector2 leftUp = RotatePoint(0, 0);
-    Vector2 leftDown = RotatePoint(0, size.y - 1);
-    Vector2 rightDown = RotatePoint(size.x - 1, size.y - 1);
-    Vector2 rightUp = RotatePoint(size.x - 1, 0);
-
-    // Compute bounding box
-    double lb = std::min({leftUp.x, leftDown.x, rightDown.x, rightUp.x});
-    double rb = std::max({leftUp.x, leftDown.x, rightDown.x, rightUp.x});
-    double ub = std::min({leftUp.y, leftDown.y, rightDown.y, rightUp.y});
-    double db = std::max({leftUp.y, leftDown.y, rightDown.y, rightUp.y});
-    #ifdef DEVELOPPER_DEBUG_MODE
-      printf("Bounding box: %lf %lf %lf %lf\n",lb, rb, ub, db);
-    #endif
-    // Scale bounds
-    double l = (pivot.x - lb) * scale.x;
-    double r = (rb - pivot.x) * scale.x;
-    double u = (pivot.y - ub) * scale.y;
-    double d = (db - pivot.y) * scale.y;
-
-    // Avoid division by zero
-    double lrSum = l + r;
-    double udSum = u + d;
-
-    // Calculate expanded bounds
-    int fr = static_cast<int>((scale.x - 1) * r / (lrSum > 1e-9 ? lrSum : 1));
-    int fl = static_cast<int>((scale.x - 1) - fr);
-    int fd = static_cast<int>((scale.y - 1) * d / (udSum > 1e-9 ? udSum : 1));
-    int fu = static_cast<int>((scale.y - 1) - fd);
-
-    if (lrSum <= 1e-9) fl = fr = 0;
-    if (udSum <= 1e-9) fu = fd = 0;
-
-    return std::make_tuple((int)l + fl, (int)r + fr, (int)u + fu, (int)d + fd);
-}
-
-
-std::string SpriteRenderer::GetCellString(int column, int line) {
-    auto pivotBounds = GetPivotBounds();
-    std::string shape;
-    if (this->useMarkdown) {
-        shape = ProcessMarkdown(shape);
-    }
-    if (this->spriteColor != Color::RESET) {
-        shape = ToAnsiCode(spriteColor) + shape + "\033[0m";
-    }
-    auto transform = parent->GetComponent<Transform>();
-    double rotation = transform->rotation;
-    Vector3 scale = transform->scale;
+static std::string ComputeCellString(const SpriteAsset &data, const SpriteRasterKey &key, int column, int line) {
+    double rotation = key.rotation;
+    Vector3 scale = key.scale;
 
     double radians = -rotation * (PI / 180.0);
-    Vector2 pivot = this->GetPivot();
+    Vector2 pivot = key.pivot;
 
     int pivotX = static_cast<int>(round(pivot.x));
     int pivotY = static_cast<int>(round(pivot.y));
@@ -294,7 +231,7 @@ std::string SpriteRenderer::GetCellString(int column, int line) {
     #endif
 
     int scaledX, scaledY;
-    std::tuple<int, int, int, int> pvex = CalculatePivotExpansion();
+    std::tuple<int, int, int, int> pvex = PivotExpansion(data, key);
 
     #ifdef DEVELOPPER_DEBUG_MODE
       printf("Pivot expansion: %d %d %d %d, ", std::get<0>(pvex), std::get<1>(pvex), std::get<2>(pvex), std::get<3>(pvex));
@@ -328,86 +265,270 @@ std::string SpriteRenderer::GetCellString(int column, int line) {
       fflush(stdout);
     #endif
 
-    std::string currentLine;
-    int currentLineIndex = 0;
-    std::stringstream ss(cleanShape);
+    if (scaledY < 0 || scaledY >= static_cast<int>(data.lines.size())) return " ";
 
-    while (std::getline(ss, currentLine, '\n')) {
-        if (currentLineIndex == scaledY) {
-            if (scaledX >= 0 && scaledX < static_cast<int>(StripAnsi(currentLine).size())) {
-                if (ansiExtracted[currentLineIndex][scaledX].empty()) {
-                    return std::string(1, currentLine[scaledX]) + ToAnsiCode(Color::RESET);
-                } else {
-                    return ansiExtracted[currentLineIndex][scaledX] + currentLine[scaledX] + ToAnsiCode(Color::RESET);
-                }
-            }
-            return " ";
-        }
-        currentLineIndex++;
+    const std::string &currentLine = data.lines[scaledY];
+    if (scaledX < 0 || scaledX >= static_cast<int>(currentLine.size())) return " ";
+
+    const std::string *ansi = nullptr;
+    if (scaledY < static_cast<int>(data.ansiExtracted.size()) &&
+        scaledX < static_cast<int>(data.ansiExtracted[scaledY].size())) {
+        ansi = &data.ansiExtracted[scaledY][scaledX];
     }
+    if (ansi == nullptr || ansi->empty()) {
+        return std::string(1, currentLine[scaledX]) + ToAnsiCode(Color::RESET);
+    }
+    return *ansi + currentLine[scaledX] + ToAnsiCode(Color::RESET);
+}
+static SpriteCell ComputeCell(const SpriteAsset &data, const SpriteRasterKey &key, int column, int line) {
+    std::string cellString = ComputeCellString(data, key, column, line);
+    std::string stripped = StripAnsi(cellString);
+
+    SpriteCell cell;
+    cell.cell = ParseCell(cellString);
+    cell.visible = stripped != " " && !stripped.empty();
+    return cell;
+}
 
-    return " ";
+// Null if the cell lies outside the raster
+static const SpriteCell *FindRasterCell(const SpriteRaster *raster, int column, int line) {
+    if (raster == nullptr) return nullptr;
+    int x = column - raster->left;
+    int y = line - raster->top;
+    if (x < 0 || x >= raster->width || y < 0 || y >= raster->height) return nullptr;
+    return &raster->cells[y * raster->width + x];
 }
-std::string SpriteRenderer::getShape() {
-  return shape;
+
+Vector2 SpriteRenderer::RotatePoint(double column, double line) {
+  return RotateAroundPivot(GetRasterKey(), column, line);
 }
 
-void SpriteRenderer::setShape(std::string target) {
-    shape = target;
-    cleanShape = StripAnsi(ProcessMarkdown(shape));
+std::tuple<int, int, int, int> SpriteRenderer::CalculatePivotExpansion() {
+    return PivotExpansion(GetAsset(), GetRasterKey());
+}
+
+std::tuple<int, int, int, int> SpriteRenderer::GetPivotBounds() {
+    Vector2 pivot = this->GetPivot();
+
+    auto transform = parent->GetComponent<Transform>();
+    Vector3 scale = transform->GetScale();
+
     
-    ss.str(cleanShape);
-    ansiExtracted = ExtractAnsi(ProcessMarkdown(shape));
+
+    Vector2 size((double)spriteWidth, (double)spriteHeight);
     
-    Vector2 size = GetSize();
-    spriteHeight = size.y;
-    spriteWidth = size.x;
+    // Get rotated corner positions
+    Vector2 leftUp = RotatePoint(0, 0);
+    Vector2 leftDown = RotatePoint(0, size.y - 1);
+    Vector2 rightDown = RotatePoint(size.x - 1, size.y - 1);
+    Vector2 rightUp = RotatePoint(size.x - 1, 0);
+
+    // Compute bounding box
+    double lb = std::min({leftUp.x, leftDown.x, rightDown.x, rightUp.x});
+    double rb = std::max({leftUp.x, leftDown.x, rightDown.x, rightUp.x});
+    double ub = std::min({leftUp.y, leftDown.y, rightDown.y, rightUp.y});
+    double db = std::max({leftUp.y, leftDown.y, rightDown.y, rightUp.y});
+    #ifdef DEVELOPPER_DEBUG_MODE
+      printf("Bounding box: %lf %lf %lf %lf\n",lb, rb, ub, db);
+    #endif
+    // Scale bounds
+    double l = (pivot.x - lb) * scale.x;
+    double r = (rb - pivot.x) * scale.x;
+    double u = (pivot.y - ub) * scale.y;
+    double d = (db - pivot.y) * scale.y;
+
+    // Avoid division by zero
+    double lrSum = l + r;
+    double udSum = u + d;
+
+    // Calculate expanded bounds
+    int fr = static_cast<int>((scale.x - 1) * r / (lrSum > 1e-9 ? lrSum : 1));
+    int fl = static_cast<int>((scale.x - 1) - fr);
+    int fd = static_cast<int>((scale.y - 1) * d / (udSum > 1e-9 ? udSum : 1));
+    int fu = static_cast<int>((scale.y - 1) - fd);
+
+    if (lrSum <= 1e-9) fl = fr = 0;
+    if (udSum <= 1e-9) fu = fd = 0;
+
+    return std::make_tuple((int)l + fl, (int)r + fr, (int)u + fu, (int)d + fd);
 }
-  
 
 
-void SpriteRenderer::alignShapeTo(double align) {
-    align = std::clamp(align, 0.0, 1.0);
+std::string SpriteRenderer::GetCellString(int column, int line) {
+    UpdateCellCache();
+    const SpriteCell& cached = GetCell(column, line);
+    if (!cached.visible) return " ";
+
+    std::string cellString = GetStyleSequence(cached.cell.style);
+    AppendGlyph(cellString, cached.cell);
+    return cellString + ToAnsiCode(Color::RESET);
+}
 
-    int spriteWidth = 0;
-    {
-        std::stringstream temp(cleanShape);
-        std::string line;
-        while (std::getline(temp, line, '\n')) {
-            spriteWidth = std::max(spriteWidth, static_cast<int>(line.size()));
+SpriteRasterKey SpriteRenderer::GetRasterKey() {
+    auto transform = parent->GetComponent<Transform>();
+
+    SpriteRasterKey key;
+    key.rotation = transform->GetRotation();
+    key.scale = transform->GetScale();
+    key.pivot = GetPivot();
+    key.pivotFactor = pivotFactor;
+    key.useRelativePivot = useRelativePivot;
+    return key;
+}
+
+void SpriteRenderer::UpdateCellCache() {
+    SpriteRasterKey key = GetRasterKey();
+    if (raster && rasterKey == key) return;
+
+    rasterKey = key;
+    raster = GetAsset().FindRaster(key);
+    if (raster) return;
+
+    // Rasterize every cell the camera can visit without rotating the view
+    auto built = std::make_shared<SpriteRaster>();
+    std::tuple<int, int, int, int> bounds = GetPivotBounds();
+    built->left = static_cast<int>(key.pivot.x) - std::get<0>(bounds);
+    built->top = static_cast<int>(key.pivot.y) - std::get<2>(bounds);
+    built->width = std::max(0, std::get<0>(bounds) + std::get<1>(bounds) + 1);
+    built->height = std::max(0, std::get<2>(bounds) + std::get<3>(bounds) + 1);
+
+    built->cells.assign(static_cast<size_t>(built->width) * built->height, SpriteCell());
+    for (int line = 0; line < built->height; line++) {
+        for (int column = 0; column < built->width; column++) {
+            built->cells[line * built->width + column] =
+                ComputeCell(GetAsset(), key, column + built->left, line + built->top);
         }
     }
 
-    std::stringstream alignedClean;
+    raster = built;
+    GetAsset().StoreRaster(key, raster);
+}
+
+const SpriteCell& SpriteRenderer::GetCell(int column, int line) {
+    if (const SpriteCell *cached = FindRasterCell(raster.get(), column, line)) return *cached;
+    uncachedCell = ComputeCell(GetAsset(), GetRasterKey(), column, line);
+    return uncachedCell;
+}
+
+SpriteCellSource SpriteRenderer::GetCellSource() {
+    UpdateCellCache();
+    return SpriteCellSource{asset, raster, rasterKey};
+}
+
+const SpriteCell &SpriteCellSource::GetCell(int column, int line, SpriteCell &scratch) const {
+    if (const SpriteCell *cached = FindRasterCell(raster.get(), column, line)) return *cached;
+    scratch = ComputeCell(asset ? *asset : EmptySpriteAsset(), key, column, line);
+    return scratch;
+}
+
+std::string SpriteRenderer::getShape() {
+  return GetAsset().shape;
+}
+
+const SpriteAsset &SpriteRenderer::GetAsset() const {
+  return asset ? *asset : EmptySpriteAsset();
+}
+
+void SpriteRenderer::SetAsset(std::shared_ptr<const SpriteAsset> target) {
+    asset = target;
+    raster = nullptr;
+    spriteWidth = GetAsset().width;
+    spriteHeight = GetAsset().height;
+    if (parent) WorkspaceIndex.MarkDirty(parent->GetInstanceID());
+}
+
+void SpriteRenderer::setShape(std::string target) {
+    SetAsset(LoadSpriteAsset(target));
+}
+
+// Builds a new asset, the current one may be shared with other sprites
+void SpriteRenderer::alignShapeTo(double align) {
+    align = std::clamp(align, 0.0, 1.0);
+
+    const SpriteAsset &current = GetAsset();
+    int spriteWidth = current.width;
+
+    std::string alignedClean;
     std::vector<std::vector<std::string>> alignedAnsi;
 
-    {
-        std::stringstream shapeStream(cleanShape);
-        std::string line;
-        size_t lineIndex = 0;
+    for (size_t lineIndex = 0; lineIndex < current.lines.size(); ++lineIndex) {
+        const std::string &line = current.lines[lineIndex];
+        int padding = static_cast<int>((spriteWidth - line.size()) * align);
+        alignedClean += std::string(padding, ' ') + line + '\n';
 
-        while (std::getline(shapeStream, line, '\n')) {
-            int padding = static_cast<int>((spriteWidth - line.size()) * align);
-            alignedClean << std::string(padding, ' ') << line << '\n';
+        if (lineIndex < current.ansiExtracted.size()) {
+            const std::vector<std::string>& ansiLine = current.ansiExtracted[lineIndex];
+            std::vector<std::string> paddedAnsi;
 
-            if (lineIndex < ansiExtracted.size()) {
-                const std::vector<std::string>& ansiLine = ansiExtracted[lineIndex];
-                std::vector<std::string> paddedAnsi;
+            // Add empty strings as padding on the left
+            paddedAnsi.resize(padding, "");
 
-                // Add empty strings as padding on the left
-                paddedAnsi.resize(padding, "");
+            // Copy original line
+            paddedAnsi.insert(paddedAnsi.end(), ansiLine.begin(), ansiLine.end());
 
-                // Copy original line
-                paddedAnsi.insert(paddedAnsi.end(), ansiLine.begin(), ansiLine.end());
+            alignedAnsi.push_back(std::move(paddedAnsi));
+        }
+    }
 
-                alignedAnsi.push_back(std::move(paddedAnsi));
-            }
+    SetAsset(MakeSpriteAsset(current.shape, alignedClean, std::move(alignedAnsi)));
+}
+
+std::shared_ptr<const SpriteAsset> MakeSpriteAsset(const std::string &shape, const std::string &cleanShape,
+                                                   std::vector<std::vector<std::string>> ansiExtracted) {
+    auto asset = std::make_shared<SpriteAsset>();
+    asset->shape = shape;
+    asset->cleanShape = cleanShape;
+    asset->ansiExtracted = std::move(ansiExtracted);
+
+    std::stringstream lines(cleanShape);
+    std::string line;
+    while (std::getline(lines, line, '\n')) {
+        asset->width = std::max(asset->width, static_cast<int>(line.size()));
+        asset->lines.push_back(line);
+    }
+    asset->height = static_cast<int>(asset->lines.size());
+    return asset;
+}
+
+std::shared_ptr<const SpriteAsset> LoadSpriteAsset(const std::string &shape) {
+    static std::mutex assetMutex;
+    static std::unordered_map<std::string, std::weak_ptr<const SpriteAsset>> assets;
+    static size_t pruneAt = 64;
+
+    std::lock_guard<std::mutex> lock(assetMutex);
+    auto it = assets.find(shape);
+    if (it != assets.end()) {
+        if (auto asset = it->second.lock()) return asset;
+    }
+
+    std::string processed = ProcessMarkdown(shape);
+    auto asset = MakeSpriteAsset(shape, StripAnsi(processed), ExtractAnsi(processed));
+    assets[shape] = asset;
 
-            ++lineIndex;
+    // Drop shapes nothing uses anymore once the table has doubled
+    if (assets.size() >= pruneAt) {
+        for (auto entry = assets.begin(); entry != assets.end();) {
+            if (entry->second.expired()) entry = assets.erase(entry);
+            else ++entry;
         }
+        pruneAt = std::max<size_t>(64, assets.size() * 2);
     }
+    return asset;
+}
 
-    cleanShape = alignedClean.str();
-    ss = std::stringstream(cleanShape);
-    ansiExtracted = std::move(alignedAnsi);
-}
\ No newline at end of file
+// Rotating or scaling sprites would keep adding keys, so the list is bounded
+static const size_t maxRastersPerAsset = 32;
+
+std::shared_ptr<const SpriteRaster> SpriteAsset::FindRaster(const SpriteRasterKey &key) const {
+    std::lock_guard<std::mutex> lock(rasterMutex);
+    for (const auto &entry : rasters) {
+        if (entry.first == key) return entry.second;
+    }
+    return nullptr;
+}
+
+void SpriteAsset::StoreRaster(const SpriteRasterKey &key, std::shared_ptr<const SpriteRaster> raster) const {
+    std::lock_guard<std::mutex> lock(rasterMutex);
+    if (rasters.size() >= maxRastersPerAsset) rasters.erase(rasters.begin());
+    rasters.emplace_back(key, std::move(raster));
+}
@@ -0,0 +1,110 @@
+#include "Silver.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TagIndex WorkspaceTags;
+TagIndex WorkspaceNames;
+
+static std::mutex tagMutex;
+static std::unordered_map<std::string, int> tagIDs = {{"", 0}};
+
+int InternTag(const std::string &tag) {
+  std::lock_guard<std::mutex> lock(tagMutex);
+  auto it = tagIDs.find(tag);
+  if (it != tagIDs.end()) return it->second;
+
+  int id = static_cast<int>(tagIDs.size());
+  tagIDs.emplace(tag, id);
+  return id;
+}
+
+int FindTagID(const std::string &tag) {
+  std::lock_guard<std::mutex> lock(tagMutex);
+  auto it = tagIDs.find(tag);
+  return it != tagIDs.end() ? it->second : -1;
+}
+
+int TagIndex::AcquireKey(const std::string &key) {
+  auto it = keyIDs.find(key);
+  if (it != keyIDs.end()) return it->second;
+
+  int keyID;
+  if (!freeKeys.empty()) {
+    keyID = freeKeys.back();
+    freeKeys.pop_back();
+    keys[keyID] = key;
+  } else {
+    keyID = static_cast<int>(keys.size());
+    keys.push_back(key);
+    buckets.emplace_back();
+  }
+  keyIDs.emplace(key, keyID);
+  return keyID;
+}
+
+void TagIndex::ReleaseKey(int keyID) {
+  keyIDs.erase(keys[keyID]);
+  keys[keyID].clear();
+  freeKeys.push_back(keyID);
+}
+
+void TagIndex::Insert(int id, const std::string &key) {
+  if (entries.count(id)) {
+    Update(id, key);
+    return;
+  }
+
+  int keyID = AcquireKey(key);
+  std::vector<int> &bucket = buckets[keyID];
+  entries[id] = Entry{keyID, bucket.size()};
+  bucket.push_back(id);
+}
+
+void TagIndex::Update(int id, const std::string &key) {
+  auto it = entries.find(id);
+  if (it == entries.end()) return; // Not placed
+  if (it->second.key == FindKey(key)) return;
+
+  Remove(id);
+  Insert(id, key);
+}
+
+void TagIndex::Remove(int id) {
+  auto it = entries.find(id);
+  if (it == entries.end()) return;
+
+  int keyID = it->second.key;
+  std::vector<int> &bucket = buckets[keyID];
+  size_t position = it->second.position;
+  int last = bucket.back();
+  bucket[position] = last;
+  entries[last].position = position;
+  bucket.pop_back();
+  entries.erase(it);
+  if (bucket.empty()) ReleaseKey(keyID);
+}
+
+void TagIndex::Clear() {
+  buckets.clear();
+  entries.clear();
+  keyIDs.clear();
+  keys.clear();
+  freeKeys.clear();
+}
+
+const std::vector<int> &TagIndex::Find(const std::string &key) const {
+  return Find(FindKey(key));
+}
+
+const std::vector<int> &TagIndex::Find(int keyID) const {
+  static const std::vector<int> none;
+  if (keyID < 0 || keyID >= static_cast<int>(buckets.size())) return none;
+  return buckets[keyID];
+}
+
+int TagIndex::FindKey(const std::string &key) const {
+  auto it = keyIDs.find(key);
+  return it != keyIDs.end() ? it->second : -1;
+}
@@ -0,0 +1,38 @@
+#include "SilverTerminal.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+// The console backend itself, Refresh, Write and Clear, is in
+// SilverConsoleWin32.cpp or SilverConsolePosix.cpp
+
+static std::mutex surfaceMutex;
+static std::shared_ptr<TerminalSurface> activeSurface;
+
+static uint64_t PackSize(int width, int height) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32 | static_cast<uint32_t>(height);
+}
+
+ConsoleSurface::ConsoleSurface() { Refresh(); }
+
+Vector2 ConsoleSurface::GetSize() {
+  uint64_t packed = size.load(std::memory_order_relaxed);
+  return Vector2(static_cast<int32_t>(packed >> 32), static_cast<int32_t>(packed & 0xffffffff));
+}
+
+void ConsoleSurface::StoreSize(int width, int height) {
+  uint64_t packed = PackSize(width, height);
+  if (size.exchange(packed, std::memory_order_relaxed) != packed) NotifyResize(Vector2(width, height));
+}
+
+void SetTerminalSurface(std::shared_ptr<TerminalSurface> surface) {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  activeSurface = surface;
+}
+
+std::shared_ptr<TerminalSurface> GetTerminalSurface() {
+  std::lock_guard<std::mutex> lock(surfaceMutex);
+  if (!activeSurface) activeSurface = std::make_shared<ConsoleSurface>();
+  return activeSurface;
+}
@@ -0,0 +1,216 @@
+#include "SilverThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+
+// Set on pool threads, so the tasks they queue land in their own deque
+static thread_local ThreadPool *currentPool = nullptr;
+static thread_local size_t currentQueue = 0;
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+  if (threadCount == 0) {
+    unsigned hardware = std::thread::hardware_concurrency();
+    threadCount = hardware > 1 ? hardware - 1 : 1;
+  }
+
+  for (unsigned i = 0; i < threadCount; i++) queues.push_back(std::unique_ptr<Queue>(new Queue()));
+  for (unsigned i = 0; i < threadCount; i++) threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &thread : threads) thread.join();
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) { Push(std::move(task), false); }
+
+void ThreadPool::Defer(std::function<void()> task) { Push(std::move(task), true); }
+
+// The back of a deque is its owner's end, the front is stolen from
+void ThreadPool::Push(std::function<void()> task, bool isDeferred) {
+  if (isDeferred) {
+    std::lock_guard<std::mutex> lock(deferred.mutex);
+    deferred.tasks.push_back(std::move(task));
+  } else {
+    size_t index = currentPool == this ? currentQueue : nextQueue++ % queues.size();
+    Queue &queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  queuedTasks++;
+
+  // Taking the lock orders this after a worker's last check before sleeping
+  { std::lock_guard<std::mutex> lock(sleepMutex); }
+  wake.notify_one();
+}
+
+bool ThreadPool::Pop(size_t self, std::function<void()> &task) {
+  if (queuedTasks.load() == 0) return false;
+
+  size_t count = queues.size();
+  if (self < count) {
+    Queue &own = *queues[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queuedTasks--;
+      return true;
+    }
+  }
+
+  size_t start = self < count ? self + 1 : nextQueue.load();
+  for (size_t i = 0; i < count; i++) {
+    size_t index = (start + i) % count;
+    if (index == self) continue;
+
+    Queue &victim = *queues[index];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queuedTasks--;
+      return true;
+    }
+  }
+
+  // Deferred tasks only run when no other work is left
+  std::lock_guard<std::mutex> lock(deferred.mutex);
+  if (deferred.tasks.empty()) return false;
+  task = std::move(deferred.tasks.front());
+  deferred.tasks.pop_front();
+  queuedTasks--;
+  return true;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+  currentPool = this;
+  currentQueue = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (Pop(index, task)) {
+      task();
+      task = nullptr; // Release captures before sleeping
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+    if (stopping) return;
+  }
+}
+
+bool ThreadPool::RunPendingTask() {
+  std::function<void()> task;
+  size_t self = currentPool == this ? currentQueue : queues.size();
+  if (!Pop(self, task)) return false;
+  task();
+  return true;
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain,
+                             const std::function<void(size_t, size_t)> &body) {
+  if (begin >= end) return;
+  grain = std::max<size_t>(grain, 1);
+  size_t chunks = (end - begin + grain - 1) / grain;
+  if (chunks == 1) {
+    body(begin, end);
+    return;
+  }
+
+  struct Shared {
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> doneChunks{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+  };
+  auto shared = std::make_shared<Shared>();
+
+  // body is only called for claimed chunks, and nothing returns before every
+  // claimed chunk is done. Helpers that start later find none left.
+  auto runChunks = [shared, begin, end, grain, chunks, &body]() {
+    for (size_t chunk; (chunk = shared->nextChunk++) < chunks;) {
+      size_t from = begin + chunk * grain;
+      try {
+        body(from, std::min(end, from + grain));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (!shared->error) shared->error = std::current_exception();
+      }
+      if (++shared->doneChunks == chunks) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->finished.notify_all();
+      }
+    }
+  };
+
+  size_t helpers = std::min<size_t>(threads.size(), chunks - 1);
+  for (size_t i = 0; i < helpers; i++) Enqueue(runChunks);
+
+  // Only this loop's chunks run here, never unrelated queued tasks
+  runChunks();
+  {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&shared, chunks] { return shared->doneChunks.load() == chunks; });
+  }
+
+  if (shared->error) std::rethrow_exception(shared->error);
+}
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+TaskGroup::TaskGroup() : pool(GetThreadPool()) {}
+
+TaskGroup::~TaskGroup() {
+  try {
+    Wait();
+  } catch (...) {
+    // Wait() was not called, nobody is left to see the error
+  }
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+  state->remaining++;
+  std::shared_ptr<State> target = state;
+  pool.Enqueue([target, task]() {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(target->mutex);
+      if (!target->error) target->error = std::current_exception();
+    }
+
+    if (--target->remaining == 0) {
+      std::lock_guard<std::mutex> lock(target->mutex);
+      target->finished.notify_all();
+    }
+  });
+}
+
+void TaskGroup::Wait() {
+  while (state->remaining.load() > 0) {
+    if (pool.RunPendingTask()) continue;
+
+    // Wake up now and then in case there is queued work to help with
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait_for(lock, std::chrono::milliseconds(1),
+                             [this] { return state->remaining.load() == 0; });
+  }
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    std::swap(error, state->error);
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+ThreadPool &GetThreadPool() {
+  static ThreadPool *pool = new ThreadPool();
+  return *pool;
+}
@@ -1,116 +1,114 @@
 #include "SilverThreading.hpp"
-#include <iostream>
-#include <windows.h>
-
-SThread::SThread() : isPaused(false), isRunning(false), hThread(NULL) {
-    InitializeCriticalSection(&queueCS);
-    hQueueEvent = CreateEvent(NULL, FALSE, FALSE, NULL);  // Auto-reset, initially non-signaled
-    hPauseEvent = CreateEvent(NULL, TRUE, TRUE, NULL);    // Manual-reset, initially signaled
-    hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);    // Manual-reset, initially non-signaled
-}
+
+SThread::SThread() : state(std::make_shared<State>()) {}
 
 SThread::~SThread() {
+    if (isDetached) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->isOrphaned = true;
+        }
+        state->wake.notify_all();
+        if (thread.joinable()) thread.detach();
+        return;
+    }
+
     StopThread();
-    DeleteCriticalSection(&queueCS);
-    CloseHandle(hQueueEvent);
-    CloseHandle(hPauseEvent);
-    CloseHandle(hStopEvent);
+    // A task destroying its own SThread cannot wait for itself
+    if (thread.joinable()) thread.detach();
 }
 
-void SThread::Enqueue(std::function<void()> task) {
-    EnterCriticalSection(&queueCS);
-    taskQueue.push(task);
-    LeaveCriticalSection(&queueCS);
-    SetEvent(hQueueEvent);
+// Holds only the state, so a detached thread outlives its SThread
+void SThread::ThreadFunction(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+        state->wake.wait(lock, [&state] {
+            return !state->isRunning || state->isOrphaned ||
+                   (!state->isPaused && !state->taskQueue.empty());
+        });
+        if (!state->isRunning) break;
+        if (state->isPaused || state->taskQueue.empty()) {
+            if (state->isOrphaned) break;
+            continue;
+        }
+
+        std::function<void()> task = std::move(state->taskQueue.front());
+        state->taskQueue.pop();
+        state->isBusy = true;
+        lock.unlock();
+
+        task();
+        task = nullptr; // Release captures outside the lock
+
+        lock.lock();
+        state->isBusy = false;
+        state->idle.notify_all();
+    }
+    state->idle.notify_all();
 }
 
-void SThread::StartThread() {
-    if (!isRunning) {
-        isRunning = true;
-        hThread = CreateThread(
-            NULL,                   // Default security attributes
-            0,                      // Default stack size
-            ThreadWrapper,          // Thread function
-            this,                   // Argument to thread function
-            0,                      // Default creation flags
-            NULL                    // Don't need thread ID
-        );
+void SThread::Enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->taskQueue.push(std::move(task));
     }
+    state->wake.notify_one();
 }
 
-void SThread::StopThread() {
-    if (isRunning) {
-        isRunning = false;
-        SetEvent(hStopEvent);
-
-        if (hThread) {
-            WaitForSingleObject(hThread, INFINITE);
-            CloseHandle(hThread);
-            hThread = NULL;
+void SThread::StartThread() {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->isRunning) return;
+        // Restarted from its own task, the loop carries on once the task ends
+        if (IsOwnThread()) {
+            state->isRunning = true;
+            return;
         }
+    }
 
-        ResetEvent(hStopEvent);
-        ResetEvent(hQueueEvent);
-        SetEvent(hPauseEvent);  // Ensure thread isn't blocked on pause
+    // Stopped from inside its own task, it may still be finishing it
+    if (thread.joinable()) thread.join();
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->isRunning = true;
     }
+    thread = std::thread(ThreadFunction, state);
 }
 
-void SThread::PauseThread() {
-    isPaused = true;
-    ResetEvent(hPauseEvent);
-}
+void SThread::StopThread() {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->isRunning = false;
+        state->isPaused = false;
+    }
+    state->wake.notify_all();
 
-void SThread::ResumeThread() {
-    isPaused = false;
-    SetEvent(hPauseEvent);
+    // A task stopping its own queue cannot wait for itself
+    if (IsOwnThread() || !thread.joinable()) return;
+    thread.join();
 }
 
-DWORD WINAPI SThread::ThreadWrapper(LPVOID lpParam) {
-    SThread* pThis = static_cast<SThread*>(lpParam);
-    pThis->ThreadFunction();
-    return 0;
+void SThread::PauseThread() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->isPaused = true;
 }
 
-void SThread::ThreadFunction() {
-    HANDLE waitHandles[3] = { hStopEvent, hQueueEvent, hPauseEvent };
-
-    while (isRunning) {
-        // Wait for either stop signal, new task, or pause state change
-        DWORD waitResult = WaitForMultipleObjects(3, waitHandles, FALSE, INFINITE);
-
-        if (waitResult == WAIT_OBJECT_0) {  // Stop event
-            break;
-        }
-        else if (waitResult == WAIT_OBJECT_0 + 1) {  // Queue event
-            EnterCriticalSection(&queueCS);
-            if (!taskQueue.empty()) {
-                auto task = taskQueue.front();
-                taskQueue.pop();
-                LeaveCriticalSection(&queueCS);
-                
-                task();
-            }
-            else {
-                LeaveCriticalSection(&queueCS);
-            }
-        }
-        else if (waitResult == WAIT_OBJECT_0 + 2) {  // Pause event
-            if (isPaused) {
-                WaitForSingleObject(hPauseEvent, INFINITE);
-            }
-        }
+void SThread::ResumeThread() {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->isPaused = false;
     }
+    state->wake.notify_all();
 }
 
 void SThread::JoinThread() {
-    if (hThread) {
-        WaitForSingleObject(hThread, INFINITE);
-    }
-}
+    if (IsOwnThread()) return;
 
-void SThread::DetachThread() {
-    if (hThread) {
-        CloseHandle(hThread);
-        hThread = NULL;
-    }
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [this] {
+        return !state->isBusy &&
+               (state->taskQueue.empty() || state->isPaused || !state->isRunning);
+    });
 }
+
+void SThread::DetachThread() { isDetached = true; }
@@ -4,11 +4,15 @@
 using namespace std::chrono;
 
 Timer::Timer() 
-    : isRunning(false), isPaused(false), accumulatedPausedTime(0) {}
+    : isRunning(false), isPaused(false), accumulatedPausedTime(0), totalDuration(0) {}
+
+long long Timer::NowNanoseconds() {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
 
 void Timer::Start() {
     if (!isRunning) {
-        startTime = high_resolution_clock::now();
+        startTime = steady_clock::now();
         isRunning = true;
         isPaused = false;
         accumulatedPausedTime = 0;
@@ -17,15 +21,14 @@ void Timer::Start() {
 
 void Timer::Pause() {
     if (isRunning && !isPaused) {
-        pauseTime = high_resolution_clock::now();
+        pauseTime = steady_clock::now();
         isPaused = true;
     }
 }
 
 void Timer::Resume() {
     if (isPaused) {
-        resumeTime = high_resolution_clock::now();
-        accumulatedPausedTime += duration_cast<milliseconds>(resumeTime - pauseTime).count();
+        accumulatedPausedTime += duration_cast<nanoseconds>(steady_clock::now() - pauseTime).count();
         isPaused = false;
     }
 }
@@ -35,8 +38,7 @@ void Timer::Stop() {
         if (isPaused) {
             Resume();
         }
-        auto stopTime = high_resolution_clock::now();
-        totalDuration = duration_cast<milliseconds>(stopTime - startTime).count() - accumulatedPausedTime;
+        totalDuration = duration_cast<nanoseconds>(steady_clock::now() - startTime).count() - accumulatedPausedTime;
         isRunning = false;
     }
 }
@@ -48,13 +50,14 @@ void Timer::Reset() {
     accumulatedPausedTime = 0;
 }
 
-long long Timer::GetElapsedTime() const {
+long long Timer::GetElapsedNanoseconds() const {
     if (isRunning) {
-        if (isPaused) {
-            return duration_cast<milliseconds>(pauseTime - startTime).count() - accumulatedPausedTime;
-        }
-        return duration_cast<milliseconds>(high_resolution_clock::now() - startTime).count() - accumulatedPausedTime;
+        steady_clock::time_point end = isPaused ? pauseTime : steady_clock::now();
+        return duration_cast<nanoseconds>(end - startTime).count() - accumulatedPausedTime;
     }
     return totalDuration;
 }
 
+long long Timer::GetElapsedTime() const {
+    return GetElapsedNanoseconds() / 1000000;
+}
@@ -0,0 +1,227 @@
+#include "Silver.hpp"
+#include <algorithm>
+#include <cmath>
+
+TimerWheel WorkspaceTimers;
+
+TimerWheel::TimerWheel(double resolution) : resolution(resolution > 0 ? resolution : 0.0001) {}
+
+uint64_t TimerWheel::ToTicks(double seconds) const {
+  if (!(seconds > 0)) return 0;
+  return static_cast<uint64_t>(std::ceil(seconds / resolution - 1e-9));
+}
+
+double TimerWheel::GetTime() const { return currentTick * resolution; }
+
+TimerHandle TimerWheel::Schedule(double delay, std::function<void()> callback) {
+  return Add(currentTick + ToTicks(delay), 0, std::move(callback));
+}
+
+TimerHandle TimerWheel::ScheduleRepeating(double interval, std::function<void()> callback,
+                                          double firstDelay) {
+  uint64_t ticks = std::max<uint64_t>(1, ToTicks(interval)); // Never due twice in one tick
+  uint64_t first = firstDelay < 0 ? ticks : ToTicks(firstDelay);
+  return Add(currentTick + first, ticks, std::move(callback));
+}
+
+TimerHandle TimerWheel::Add(uint64_t due, uint64_t interval, std::function<void()> callback) {
+  int index;
+  if (!freeNodes.empty()) {
+    index = freeNodes.back();
+    freeNodes.pop_back();
+  } else {
+    index = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+  }
+
+  Node &node = nodes[index];
+  node.callback = std::move(callback);
+  node.due = due;
+  node.interval = interval;
+  Place(index);
+  pending++;
+  return TimerHandle{index, node.generation};
+}
+
+bool TimerWheel::IsPending(TimerHandle handle) const {
+  if (handle.slot < 0 || handle.slot >= static_cast<int>(nodes.size())) return false;
+  const Node &node = nodes[handle.slot];
+  return node.list >= 0 && node.generation == handle.generation;
+}
+
+bool TimerWheel::Cancel(TimerHandle handle) {
+  if (!IsPending(handle)) return false;
+  Unlink(handle.slot);
+  Release(handle.slot);
+  return true;
+}
+
+void TimerWheel::Clear() {
+  for (int index = 0; index < static_cast<int>(nodes.size()); index++) {
+    if (nodes[index].list < 0) continue;
+    Unlink(index);
+    Release(index);
+  }
+}
+
+// Files the node under the lowest level whose slot its due tick shares
+// every higher digit with the current tick
+void TimerWheel::Place(int index) {
+  uint64_t due = nodes[index].due;
+  if (due <= currentTick) {
+    Link(index, dueList);
+    return;
+  }
+
+  uint64_t differing = due ^ currentTick;
+  int level = 0;
+  while (level < levels - 1 && (differing >> (levelBits * (level + 1))) != 0) level++;
+
+  // Past the top level: park in the farthest slot and re-file when it comes up
+  uint64_t span = uint64_t(1) << (levelBits * levels);
+  if ((differing >> (levelBits * levels)) != 0) due = currentTick + span - 1;
+
+  int slot = static_cast<int>((due >> (levelBits * level)) & (slotsPerLevel - 1));
+  Link(index, level * slotsPerLevel + slot);
+}
+
+void TimerWheel::Link(int index, int list) {
+  Node &node = nodes[index];
+  node.list = list;
+  node.prev = -1;
+  node.next = heads[list];
+  if (node.next >= 0) nodes[node.next].prev = index;
+  heads[list] = index;
+
+  if (list < dueList) occupied[list / slotsPerLevel][(list % slotsPerLevel) / 64] |= uint64_t(1) << (list % 64);
+}
+
+void TimerWheel::Unlink(int index) {
+  Node &node = nodes[index];
+  if (node.prev >= 0) {
+    nodes[node.prev].next = node.next;
+  } else {
+    heads[node.list] = node.next;
+  }
+  if (node.next >= 0) nodes[node.next].prev = node.prev;
+
+  int list = node.list;
+  if (list < dueList && heads[list] < 0) {
+    occupied[list / slotsPerLevel][(list % slotsPerLevel) / 64] &= ~(uint64_t(1) << (list % 64));
+  }
+  node.list = -1;
+  node.prev = node.next = -1;
+}
+
+void TimerWheel::Release(int index) {
+  Node &node = nodes[index];
+  node.callback = nullptr;
+  node.generation++;
+  freeNodes.push_back(index);
+  pending--;
+}
+
+int TimerWheel::NextOccupied(int level, int from) const {
+  for (int word = from / 64; word < slotsPerLevel / 64; word++) {
+    uint64_t bits = occupied[level][word];
+    if (word == from / 64) bits &= ~uint64_t(0) << (from % 64);
+    if (bits == 0) continue;
+    int bit = 0;
+    while ((bits & 1) == 0) {
+      bits >>= 1;
+      bit++;
+    }
+    return word * 64 + bit;
+  }
+  return -1;
+}
+
+// Re-files the slot of level the current tick just entered
+void TimerWheel::Cascade(int level) {
+  int slot = static_cast<int>((currentTick >> (levelBits * level)) & (slotsPerLevel - 1));
+  int list = level * slotsPerLevel + slot;
+  while (heads[list] >= 0) {
+    int index = heads[list];
+    Unlink(index);
+    Place(index);
+  }
+}
+
+// Fires every node in list. Repeating timers are filed again before their
+// callback runs, so the callback may cancel them.
+size_t TimerWheel::FireList(int list) {
+  // Moved aside first, so timers added by callbacks wait for their own slot
+  while (heads[list] >= 0) {
+    int index = heads[list];
+    Unlink(index);
+    Link(index, firingList);
+  }
+
+  size_t fired = 0;
+  while (heads[firingList] >= 0) {
+    int index = heads[firingList];
+    Unlink(index);
+    Node &node = nodes[index];
+    std::function<void()> callback;
+
+    if (node.interval > 0) {
+      node.due += node.interval;
+      if (node.due <= currentTick) node.due = currentTick + node.interval; // Skip missed periods
+      callback = node.callback;
+      Place(index);
+    } else {
+      callback = std::move(node.callback);
+      Release(index);
+    }
+
+    callback(); // nodes may grow, node is not used past here
+    fired++;
+  }
+  return fired;
+}
+
+size_t TimerWheel::AdvanceBy(double seconds) {
+  uint64_t target = currentTick + ToTicks(seconds);
+  size_t fired = FireList(dueList);
+
+  while (currentTick < target) {
+    if (pending == 0) {
+      currentTick = target;
+      break;
+    }
+
+    // Jump to the next occupied level 0 slot before the block ends
+    int slot = static_cast<int>(currentTick & (slotsPerLevel - 1));
+    uint64_t blockStart = currentTick - slot;
+    int next = slot + 1 < slotsPerLevel ? NextOccupied(0, slot + 1) : -1;
+    if (next >= 0 && blockStart + next <= target) {
+      currentTick = blockStart + next;
+      fired += FireList(next);
+      continue;
+    }
+
+    uint64_t blockEnd = blockStart + slotsPerLevel;
+    if (blockEnd > target) {
+      currentTick = target;
+      break;
+    }
+
+    // Entering a new block: bring down every level whose slot just changed,
+    // coarsest first, then fire what landed on this tick
+    currentTick = blockEnd;
+    int top = 1;
+    while (top < levels - 1 && (currentTick & ((uint64_t(1) << (levelBits * (top + 1))) - 1)) == 0) top++;
+    for (int level = top; level >= 1; level--) Cascade(level);
+    fired += FireList(0);
+    fired += FireList(dueList);
+  }
+
+  return fired;
+}
+
+size_t TimerWheel::Advance() {
+  long long now = Timer::NowNanoseconds();
+  double elapsed = lastClock < 0 ? 0 : (now - lastClock) / 1e9;
+  lastClock = now;
+  return AdvanceBy(elapsed);
+}
@@ -0,0 +1,212 @@
+#include "Silver.hpp"
+#include <algorithm>
+#include <vector>
+
+TransformPool &GetTransformPool() {
+  static TransformPool *pool = new TransformPool();
+  return *pool;
+}
+
+int TransformPool::DenseIndex(TransformHandle handle) const {
+  if (handle.slot < 0 || handle.slot >= static_cast<int>(slotRows.size())) return -1;
+  if (slotGenerations[handle.slot] != handle.generation) return -1;
+  return slotRows[handle.slot];
+}
+
+bool TransformPool::Contains(TransformHandle handle) const {
+  return DenseIndex(handle) >= 0;
+}
+
+TransformHandle TransformPool::Add(Transform *owner) {
+  TransformHandle handle;
+  if (!freeSlots.empty()) {
+    handle.slot = freeSlots.back();
+    freeSlots.pop_back();
+  } else {
+    handle.slot = static_cast<int>(slotRows.size());
+    slotRows.push_back(-1);
+    slotGenerations.push_back(0);
+  }
+  handle.generation = slotGenerations[handle.slot];
+
+  int row = static_cast<int>(owners.size());
+  slotRows[handle.slot] = row;
+  rowSlots.push_back(handle.slot);
+  owners.push_back(owner);
+
+  // The owner is not dense yet, so these are its own fields
+  Vector3 position = owner->GetPosition(), scale = owner->GetScale();
+  positionX.push_back(position.x);
+  positionY.push_back(position.y);
+  positionZ.push_back(position.z);
+  rotation.push_back(owner->GetRotation());
+  scaleX.push_back(scale.x);
+  scaleY.push_back(scale.y);
+  scaleZ.push_back(scale.z);
+  velocityX.push_back(0);
+  velocityY.push_back(0);
+  velocityZ.push_back(0);
+  tags.push_back(owner->GetParent() ? InternTag(owner->GetParent()->GetTag()) : 0);
+  changed.push_back(0);
+
+  return handle;
+}
+
+// Moves the last row into the freed one so the arrays stay packed
+void TransformPool::Remove(TransformHandle handle) {
+  int row = DenseIndex(handle);
+  if (row < 0) return;
+
+  int last = static_cast<int>(owners.size()) - 1;
+  if (row != last) {
+    positionX[row] = positionX[last];
+    positionY[row] = positionY[last];
+    positionZ[row] = positionZ[last];
+    rotation[row] = rotation[last];
+    scaleX[row] = scaleX[last];
+    scaleY[row] = scaleY[last];
+    scaleZ[row] = scaleZ[last];
+    velocityX[row] = velocityX[last];
+    velocityY[row] = velocityY[last];
+    velocityZ[row] = velocityZ[last];
+    tags[row] = tags[last];
+    changed[row] = changed[last];
+    owners[row] = owners[last];
+    rowSlots[row] = rowSlots[last];
+    slotRows[rowSlots[row]] = row;
+  }
+
+  positionX.pop_back();
+  positionY.pop_back();
+  positionZ.pop_back();
+  rotation.pop_back();
+  scaleX.pop_back();
+  scaleY.pop_back();
+  scaleZ.pop_back();
+  velocityX.pop_back();
+  velocityY.pop_back();
+  velocityZ.pop_back();
+  tags.pop_back();
+  changed.pop_back();
+  owners.pop_back();
+  rowSlots.pop_back();
+
+  slotRows[handle.slot] = -1;
+  slotGenerations[handle.slot]++;
+  freeSlots.push_back(handle.slot);
+}
+
+Vector3 TransformPool::GetPosition(TransformHandle handle) const {
+  int row = DenseIndex(handle);
+  if (row < 0) return Vector3(0, 0, 0);
+  return Vector3(positionX[row], positionY[row], positionZ[row]);
+}
+
+void TransformPool::SetPosition(TransformHandle handle, Vector3 position) {
+  int row = DenseIndex(handle);
+  if (row < 0) return;
+  positionX[row] = position.x;
+  positionY[row] = position.y;
+  positionZ[row] = position.z;
+}
+
+double TransformPool::GetRotation(TransformHandle handle) const {
+  int row = DenseIndex(handle);
+  return row < 0 ? 0 : rotation[row];
+}
+
+void TransformPool::SetRotation(TransformHandle handle, double value) {
+  int row = DenseIndex(handle);
+  if (row >= 0) rotation[row] = value;
+}
+
+Vector3 TransformPool::GetScale(TransformHandle handle) const {
+  int row = DenseIndex(handle);
+  if (row < 0) return Vector3(1, 1, 1);
+  return Vector3(scaleX[row], scaleY[row], scaleZ[row]);
+}
+
+void TransformPool::SetScale(TransformHandle handle, Vector3 scale) {
+  int row = DenseIndex(handle);
+  if (row < 0) return;
+  scaleX[row] = scale.x;
+  scaleY[row] = scale.y;
+  scaleZ[row] = scale.z;
+}
+
+Vector3 TransformPool::GetVelocity(TransformHandle handle) const {
+  int row = DenseIndex(handle);
+  if (row < 0) return Vector3(0, 0, 0);
+  return Vector3(velocityX[row], velocityY[row], velocityZ[row]);
+}
+
+void TransformPool::SetVelocity(TransformHandle handle, Vector3 velocity) {
+  int row = DenseIndex(handle);
+  if (row < 0) return;
+  velocityX[row] = velocity.x;
+  velocityY[row] = velocity.y;
+  velocityZ[row] = velocity.z;
+}
+
+int TransformPool::GetTag(TransformHandle handle) const {
+  int row = DenseIndex(handle);
+  return row < 0 ? 0 : tags[row];
+}
+
+void TransformPool::SetTag(TransformHandle handle, int tag) {
+  int row = DenseIndex(handle);
+  if (row >= 0) tags[row] = tag;
+}
+
+void TransformPool::TranslateAll(Vector3 offset) {
+  size_t count = owners.size();
+  for (size_t i = 0; i < count; i++) positionX[i] += offset.x;
+  for (size_t i = 0; i < count; i++) positionY[i] += offset.y;
+  for (size_t i = 0; i < count; i++) positionZ[i] += offset.z;
+  std::fill(changed.begin(), changed.end(), 1);
+  Publish();
+}
+
+void TransformPool::TranslateTagged(int tag, Vector3 offset) {
+  size_t count = owners.size();
+  const int *tagData = tags.data();
+  double *x = positionX.data(), *y = positionY.data(), *z = positionZ.data();
+  uint8_t *moved = changed.data();
+
+  // Branch free so the loop vectorizes, untagged rows add zero
+  for (size_t i = 0; i < count; i++) {
+    double match = tagData[i] == tag;
+    x[i] += offset.x * match;
+    y[i] += offset.y * match;
+    z[i] += offset.z * match;
+    moved[i] |= static_cast<uint8_t>(tagData[i] == tag);
+  }
+  Publish();
+}
+
+void TransformPool::AdvanceVelocities(double deltaTime) {
+  size_t count = owners.size();
+  double *x = positionX.data(), *y = positionY.data(), *z = positionZ.data();
+  const double *vx = velocityX.data(), *vy = velocityY.data(), *vz = velocityZ.data();
+  uint8_t *moved = changed.data();
+
+  for (size_t i = 0; i < count; i++) {
+    x[i] += vx[i] * deltaTime;
+    y[i] += vy[i] * deltaTime;
+    z[i] += vz[i] * deltaTime;
+    moved[i] |= static_cast<uint8_t>((vx[i] != 0) | (vy[i] != 0) | (vz[i] != 0));
+  }
+  Publish();
+}
+
+void TransformPool::Publish() {
+  movedIDs.clear();
+  for (size_t i = 0; i < owners.size(); i++) {
+    if (!changed[i]) continue;
+    changed[i] = 0;
+
+    Transform *owner = owners[i];
+    if (owner->GetParent()) movedIDs.push_back(owner->GetParent()->GetInstanceID());
+  }
+  WorkspaceIndex.MarkDirty(movedIDs);
+}
@@ -1,14 +1,12 @@
 #include "Silver.hpp"
 #include "SilverVMouse.hpp"
 #include "SilverKeyboard.hpp"
-#include <windows.h>
 
 using namespace std;
 
 // Global variables
 bool VMouse = false;
-HANDLE hVMouseThread = NULL;
-CRITICAL_SECTION mouseCS;
+static int vmouseKeys[4] = {0, 0, 0, 0}; // Left, right, up, down
 
 int mouseKey;
 int cursorPositionX = 0;
@@ -16,32 +14,21 @@ int cursorPositionY = 0;
 std::string mouseIcon = "O";
 bool hideMouse = false;
 
-// Virtual mouse movement function
-DWORD WINAPI VMouseOn(LPVOID lpParam) {
-    int* keys = (int*)lpParam;
-    int leftKey = keys[0], rightKey = keys[1], upKey = keys[2], downKey = keys[3];
+void StepVMouse(const KeySet &keys) {
+    if (!VMouse) return;
 
-    while (VMouse) {
-        EnterCriticalSection(&mouseCS);
-
-        if (IsKey(leftKey)) {
-            cursorPositionX--;
-        }
-        if (IsKey(rightKey)) {
-            cursorPositionX++;
-        }
-        if (IsKey(upKey)) {
-            cursorPositionY--;
-        }
-        if (IsKey(downKey)) {
-            cursorPositionY++;
-        }
-
-        LeaveCriticalSection(&mouseCS);
-        Sleep(10);  // Reduce CPU usage
+    if (keys.Test(vmouseKeys[0])) {
+        cursorPositionX--;
+    }
+    if (keys.Test(vmouseKeys[1])) {
+        cursorPositionX++;
+    }
+    if (keys.Test(vmouseKeys[2])) {
+        cursorPositionY--;
+    }
+    if (keys.Test(vmouseKeys[3])) {
+        cursorPositionY++;
     }
-
-    return 0;
 }
 
 // Start virtual mouse
@@ -53,20 +40,16 @@ void StartVMouse(int leftKey, int rightKey, int upKey, int downKey, int clickKey
     VMouse = true;
     mouseKey = clickKey;
 
-    static int keys[4] = { leftKey, rightKey, upKey, downKey };
-    hVMouseThread = CreateThread(NULL, 0, VMouseOn, keys, 0, NULL);
+    vmouseKeys[0] = leftKey;
+    vmouseKeys[1] = rightKey;
+    vmouseKeys[2] = upKey;
+    vmouseKeys[3] = downKey;
 }
 
 // Stop virtual mouse
 void StopVMouse() {
     hideMouse = true;
     VMouse = false;
-
-    if (hVMouseThread) {
-        WaitForSingleObject(hVMouseThread, INFINITE);
-        CloseHandle(hVMouseThread);
-        hVMouseThread = NULL;
-    }
 }
 
 // Check if the mouse was clicked
@@ -6,7 +6,7 @@ int main() {
 
     Actor actor("alert", "123\n456");
     
-    actor.GetComponent<Transform>()->position = Vector3Zero;
+    actor.GetComponent<Transform>()->SetPosition(Vector3Zero);
     //actor.GetComponent<SpriteRenderer>()->alignShapeTo(1.0f);
 
     actor.AddObject();
@@ -0,0 +1,45 @@
+// Checks both ways ShakeCamera runs: blocking when nothing updates scripts,
+// and as a script once UpdateScripts is being called.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(std::make_shared<HeadlessSurface>(40, 12));
+  camera->position = Vector3(3, 4, 0);
+
+  // Nothing has updated scripts, so the shake runs before the call returns
+  Check(!AreScriptsUpdating(), "no scripts are being updated yet");
+  auto start = std::chrono::steady_clock::now();
+  camera->ShakeCamera(5, 4, 10);
+  Check(MillisecondsSince(start) >= 40, "a shake without a tick blocks for every shake");
+  Check(camera->position == Vector3(3, 4, 0), "a blocking shake ends where it started");
+  Check(GetScriptCount() == 0, "a blocking shake starts no script");
+
+  // Once scripts are updated, the shake is a script and returns at once
+  UpdateScripts(0);
+  Check(AreScriptsUpdating(), "scripts count as updated after UpdateScripts");
+  camera->ShakeCamera(5, 4, 10);
+  Check(GetScriptCount() == 1, "a ticked shake runs as a script");
+  for (int i = 0; i < 10; i++) UpdateScripts(0.01);
+  Check(GetScriptCount() == 0, "the shake script finishes");
+  Check(camera->position == Vector3(3, 4, 0), "a scripted shake ends where it started");
+
+  if (failures == 0) std::printf("CameraShakeTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
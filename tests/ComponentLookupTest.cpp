@@ -0,0 +1,45 @@
+// Checks GetComponent for exact types, base classes and missing components.
+#include "Silver.hpp"
+#include <cstdio>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+struct Health : Component {
+  Health() = default;
+  explicit Health(Actor *parent) : Component(parent) {}
+  std::shared_ptr<Component> Clone() const override { return std::make_shared<Health>(*this); }
+  void Update(float) override {}
+  int points = 10;
+};
+
+// A concrete component a game extends
+struct Shield : Health {
+  std::shared_ptr<Component> Clone() const override { return std::make_shared<Shield>(*this); }
+  int armor = 3;
+};
+
+int main() {
+  Actor actor("unit", "u");
+  Check(actor.GetComponent<Transform>() != nullptr, "the Transform is found by its slot");
+  Check(actor.GetComponent<Health>() == nullptr, "a missing component is nullptr");
+
+  auto shield = std::make_shared<Shield>();
+  actor.AddComponent(shield);
+  Check(actor.GetComponent<Shield>() == shield.get(), "a component is found by its own type");
+  Check(actor.GetComponent<Health>() == shield.get(), "and by a concrete base class");
+  Check(actor.GetComponent<Component>() != nullptr, "and by the abstract base");
+  Check(actor.AddComponent<Health>() == nullptr, "a base is not added next to its derived type");
+
+  Check(actor.RemoveComponent<Health>(), "removing by base class removes the derived component");
+  Check(actor.GetComponent<Shield>() == nullptr, "the derived component is gone");
+
+  if (failures == 0) std::printf("ComponentLookupTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// Renders through a HeadlessSurface and checks the decoded screen, so the
+// camera is tested without a console or <windows.h>.
+#include "Silver.hpp"
+#include <cstdio>
+#include <string>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static std::string Row(HeadlessSurface &surface, int y, int x, int width) {
+  std::string text;
+  for (int i = 0; i < width; i++) text += static_cast<char>(surface.GetCell(x + i, y).codepoint);
+  return text;
+}
+
+int main() {
+  auto surface = std::make_shared<HeadlessSurface>(40, 12);
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(surface);
+  camera->backgroundPattern = " ";
+
+  Actor prototype("box", "ab\ncd");
+  prototype.PlaceObjectAt(Vector3(0, 0, 0));
+  std::shared_ptr<Actor> box = FindObjectWithName("box");
+  Check(box != nullptr, "the placed actor is found by name");
+
+  // The sprite's pivot is its centre, the camera's is the view centre
+  camera->RenderFrame();
+  Check(Row(*surface, 5, 19, 2) == "ab", "first sprite row at the view centre");
+  Check(Row(*surface, 6, 19, 2) == "cd", "second sprite row below it");
+  Check(surface->GetFrames().size() == 1, "one write for the first frame");
+
+  // Nothing changed, so nothing is written
+  camera->RenderFrame();
+  Check(camera->GetFrameStats().writes == 0, "an unchanged frame writes nothing");
+
+  // Only the moved cells are rewritten
+  box->GetComponent<Transform>()->SetPosition(Vector3(3, 1, 0));
+  camera->RenderFrame();
+  Check(Row(*surface, 5, 19, 2) == "  ", "the old position is cleared");
+  Check(Row(*surface, 6, 22, 2) == "ab", "the sprite is drawn at its new position");
+  Check(Row(*surface, 7, 22, 2) == "cd", "with its second row below");
+
+  // An actor moved in from far outside the view is picked up by the
+  // spatial index and drawn
+  Actor farPrototype("far", "F");
+  farPrototype.PlaceObjectAt(Vector3(-200, 0, 0));
+  camera->RenderFrame();
+  FindObjectWithName("far")->GetComponent<Transform>()->SetPosition(Vector3(-5, -2, 0));
+  camera->RenderFrame();
+  Check(Row(*surface, 4, 15, 1) == "F", "an actor moved into view is drawn");
+
+  // A resized surface is redrawn in full at its new centre
+  surface->SetSize(20, 8);
+  camera->RenderFrame();
+  Check(Row(*surface, 4, 12, 2) == "ab", "the sprite follows the new view centre");
+
+  if (failures == 0) std::printf("HeadlessRenderTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Records a scripted input session, replays the log and checks that the
+// keys, the cursor and the headless frames they drive come out the same.
+#include "Silver.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+// Plays a fixed list of frames, standing in for a player
+class ScriptedInputSource : public InputSource {
+public:
+  explicit ScriptedInputSource(std::vector<InputFrame> frames) : frames(std::move(frames)) {}
+
+  void Read(InputFrame &frame) override {
+    if (next < frames.size()) frame = frames[next++];
+  }
+  bool ProvidesCursor() const override { return true; }
+
+private:
+  std::vector<InputFrame> frames;
+  size_t next = 0;
+};
+
+// What one poll left behind, plus the frame it led to
+struct Observed {
+  bool right, rightDown, rightUp, space;
+  int cursorX, cursorY;
+  std::string screen;
+
+  bool operator==(const Observed &other) const {
+    return right == other.right && rightDown == other.rightDown && rightUp == other.rightUp &&
+           space == other.space && cursorX == other.cursorX && cursorY == other.cursorY &&
+           screen == other.screen;
+  }
+};
+
+static std::vector<Observed> RunSession(int frames) {
+  auto surface = std::make_shared<HeadlessSurface>(20, 5);
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(surface);
+  camera->backgroundPattern = " ";
+
+  Actor prototype("player", "@");
+  prototype.PlaceObjectAt(Vector3(0, 0, 0));
+  Transform *player = FindObjectWithName("player")->GetComponent<Transform>();
+
+  std::vector<Observed> observed;
+  for (int i = 0; i < frames; i++) {
+    PollEvents();
+    if (IsKey(KEY_RIGHT)) player->Translate(Vector3(1, 0, 0));
+    camera->RenderFrame();
+    observed.push_back(Observed{IsKey(KEY_RIGHT), IsKeyDown(KEY_RIGHT), IsKeyUp(KEY_RIGHT),
+                                IsKey(KEY_SPACE), cursorPositionX, cursorPositionY,
+                                surface->GetScreenText()});
+  }
+
+  Workspace.clear();
+  return observed;
+}
+
+int main() {
+  const std::string path = "InputReplayTest.log";
+
+  std::vector<InputFrame> script(8);
+  for (int i = 1; i <= 4; i++) script[i].keys.Set(KEY_RIGHT, true);
+  script[3].keys.Set(KEY_SPACE, true);
+  for (int i = 0; i < 8; i++) script[i].cursorX = i, script[i].cursorY = i / 2;
+
+  SetInputSource(std::make_shared<ScriptedInputSource>(script));
+  Check(StartInputRecording(path), "recording starts");
+  std::vector<Observed> recorded = RunSession(8);
+  StopInputRecording();
+
+  auto replay = std::make_shared<ReplayInputSource>(path);
+  Check(replay->IsOpen(), "the log opens for replay");
+  SetInputSource(replay);
+  std::vector<Observed> replayed = RunSession(8);
+  SetInputSource(nullptr);
+
+  Check(replay->GetFramesRead() == 8, "every recorded frame is read back");
+  Check(recorded.size() == replayed.size(), "both sessions ran the same frames");
+  for (size_t i = 0; i < recorded.size() && i < replayed.size(); i++) {
+    Check(recorded[i] == replayed[i], "a replayed frame matches the recorded one");
+  }
+  Check(recorded[1].rightDown && recorded[5].rightUp, "the script pressed and released a key");
+  Check(recorded[1].screen != recorded[4].screen, "the key moved the player");
+
+  std::remove(path.c_str());
+  if (failures == 0) std::printf("InputReplayTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// Checks the tag and name lookups as actors come and go, and that unique
+// names do not pile up in the indexes or the tag table.
+#include "Silver.hpp"
+#include <cstdio>
+#include <string>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static int CountWithTag(const std::string &tag) {
+  int count = 0;
+  ForEachObjectWithTag(tag, [&](const std::shared_ptr<Actor> &) { count++; });
+  return count;
+}
+
+int main() {
+  Actor enemy("enemy", "e");
+  enemy.SetTag("hostile");
+  for (int i = 0; i < 3; i++) enemy.PlaceObjectAt(Vector3(i, 0, 0));
+  Check(CountWithTag("hostile") == 3, "placed actors are found by tag");
+
+  size_t nameKeys = WorkspaceNames.GetKeyCount();
+  size_t tagKeys = WorkspaceTags.GetKeyCount();
+
+  // Spawn and remove many uniquely named actors
+  for (int i = 0; i < 1000; i++) {
+    Actor spawned("bullet-" + std::to_string(i), "*");
+    spawned.PlaceObject();
+    std::shared_ptr<Actor> placed = FindObjectWithName("bullet-" + std::to_string(i));
+    Check(placed != nullptr, "a uniquely named actor is found by name");
+    if (placed) placed->RemoveObject();
+  }
+  Check(WorkspaceNames.GetKeyCount() == nameKeys, "names of removed actors leave the name index");
+  Check(WorkspaceTags.GetKeyCount() == tagKeys, "the tag index is unchanged");
+  Check(FindTagID("bullet-7") < 0, "names are not interned as tags");
+
+  // A renamed actor moves to its new name, and its old one is released
+  std::shared_ptr<Actor> first = FindObjectWithName("enemy");
+  first->SetName("boss");
+  Check(FindObjectWithName("boss") == first, "a renamed actor is found by its new name");
+  Check(WorkspaceNames.Find("enemy").size() == 2, "the others keep the old name");
+
+  // Removing every actor with the tag during the walk ends it cleanly
+  ForEachObjectWithTag("hostile", [](const std::shared_ptr<Actor> &actor) { actor->RemoveObject(); });
+  Check(CountWithTag("hostile") == 0, "the walk removed every tagged actor");
+  Check(WorkspaceTags.FindKey("hostile") < 0, "an unused tag leaves the index");
+
+  if (failures == 0) std::printf("TagIndexTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
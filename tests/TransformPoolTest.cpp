@@ -0,0 +1,55 @@
+// Checks that a dense Transform reads and writes its TransformPool row, and
+// that batch updates reach the camera through the spatial index.
+#include "Silver.hpp"
+#include <cstdio>
+#include <string>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+int main() {
+  auto surface = std::make_shared<HeadlessSurface>(40, 12);
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(surface);
+  camera->backgroundPattern = " ";
+
+  Actor prototype("unit", "U");
+  prototype.SetTag("enemy");
+  prototype.GetComponent<Transform>()->SetDense(true);
+  prototype.PlaceObjectAt(Vector3(0, 0, 0));
+  Transform *unit = FindObjectWithName("unit")->GetComponent<Transform>();
+  Check(unit->IsDense(), "a copy of a dense transform is dense");
+
+  TransformPool &pool = GetTransformPool();
+  unit->SetRotation(90);
+  unit->SetScale(Vector3(2, 1, 1));
+  Check(pool.GetRotation(unit->GetHandle()) == 90, "SetRotation writes the row");
+  Check(pool.GetScale(unit->GetHandle()) == Vector3(2, 1, 1), "SetScale writes the row");
+  unit->SetRotation(0);
+  unit->SetScale(Vector3(1, 1, 1));
+
+  camera->RenderFrame();
+  Check(surface->GetCell(20, 6).codepoint == 'U', "the dense actor is drawn");
+
+  // A batch update is what the getters and the camera see
+  pool.TranslateTagged(InternTag("enemy"), Vector3(-200, 0, 0));
+  Check(unit->GetPosition() == Vector3(-200, 0, 0), "GetPosition reads the row");
+  pool.TranslateAll(Vector3(205, 2, 0));
+  camera->RenderFrame();
+  Check(surface->GetCell(20, 6).codepoint == ' ', "the old cell is cleared");
+  Check(surface->GetCell(25, 8).codepoint == 'U', "the batch move is drawn");
+
+  // Leaving the pool keeps the transform where it was
+  unit->SetDense(false);
+  Check(!unit->IsDense() && unit->GetPosition() == Vector3(5, 2, 0), "SetDense(false) keeps the position");
+
+  if (failures == 0) std::printf("TransformPoolTest passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Runs a camera on the video thread against a HeadlessSurface and checks
+// that it draws only what the game thread published.
+#include "Silver.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static std::string Row(HeadlessSurface &surface, int y, int x, int width) {
+  std::string text;
+  for (int i = 0; i < width; i++) text += static_cast<char>(surface.GetCell(x + i, y).codepoint);
+  return text;
+}
+
+// Gives the video thread, at 10 frames a second, a few frames to catch up
+static void WaitFrames() { std::this_thread::sleep_for(std::chrono::milliseconds(400)); }
+
+int main() {
+  auto surface = std::make_shared<HeadlessSurface>(40, 12);
+  Actor cameraActor;
+  Camera *camera = cameraActor.AddComponent<Camera>();
+  camera->SetSurface(surface);
+  camera->backgroundPattern = " ";
+
+  Actor prototype("box", "ab");
+  prototype.PlaceObjectAt(Vector3(0, 0, 0));
+  Transform *box = FindObjectWithName("box")->GetComponent<Transform>();
+
+  // StartVideo publishes the first snapshot
+  camera->StartVideo();
+  WaitFrames();
+  Check(Row(*surface, 6, 19, 2) == "ab", "the first snapshot is drawn");
+
+  // A move is not seen until it is published
+  box->SetPosition(Vector3(5, 0, 0));
+  WaitFrames();
+  Check(Row(*surface, 6, 19, 2) == "ab", "an unpublished move is not drawn");
+
+  PublishRenderSnapshots();
+  WaitFrames();
+  Check(Row(*surface, 6, 24, 2) == "ab", "a published move is drawn");
+
+  // RenderFrame on a running camera publishes rather than drawing itself
+  box->SetPosition(Vector3(-5, 0, 0));
+  camera->RenderFrame();
+  WaitFrames();
+  Check(Row(*surface, 6, 14, 2) == "ab", "RenderFrame hands the frame to the video thread");
+
+  camera->StopVideo();
+  Check(!camera->isRunningCam, "the camera stopped");
+
+  if (failures == 0) std::printf("VideoThreadTest passed\n");
+  return failures == 0 ? 0 : 1;
+}